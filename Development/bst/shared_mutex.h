@@ -23,6 +23,11 @@ namespace bst
 {
     using bst_shared_mutex::shared_mutex;
     using bst_shared_mutex::shared_lock;
+#ifdef BST_SHARED_MUTEX_BOOST
+    // boost::shared_mutex also meets the UpgradeLockable requirements, but std::shared_mutex has no equivalent
+    using bst_shared_mutex::upgrade_lock;
+    using bst_shared_mutex::upgrade_to_unique_lock;
+#endif
 }
 
 #endif
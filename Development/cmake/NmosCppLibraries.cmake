@@ -576,6 +576,7 @@ set(NMOS_CPP_NMOS_SOURCES
     ${NMOS_CPP_DIR}/nmos/connection_resources.cpp
     ${NMOS_CPP_DIR}/nmos/events_api.cpp
     ${NMOS_CPP_DIR}/nmos/events_resources.cpp
+    ${NMOS_CPP_DIR}/nmos/events_subscribers.cpp
     ${NMOS_CPP_DIR}/nmos/events_ws_api.cpp
     ${NMOS_CPP_DIR}/nmos/events_ws_client.cpp
     ${NMOS_CPP_DIR}/nmos/filesystem_route.cpp
@@ -586,6 +587,8 @@ set(NMOS_CPP_NMOS_SOURCES
     ${NMOS_CPP_DIR}/nmos/logging_api.cpp
     ${NMOS_CPP_DIR}/nmos/mdns.cpp
     ${NMOS_CPP_DIR}/nmos/mdns_api.cpp
+    ${NMOS_CPP_DIR}/nmos/metrics_api.cpp
+    ${NMOS_CPP_DIR}/nmos/model_transaction.cpp
     ${NMOS_CPP_DIR}/nmos/node_api.cpp
     ${NMOS_CPP_DIR}/nmos/node_api_target_handler.cpp
     ${NMOS_CPP_DIR}/nmos/node_behaviour.cpp
@@ -597,10 +600,13 @@ set(NMOS_CPP_NMOS_SOURCES
     ${NMOS_CPP_DIR}/nmos/query_utils.cpp
     ${NMOS_CPP_DIR}/nmos/query_ws_api.cpp
     ${NMOS_CPP_DIR}/nmos/registration_api.cpp
+    ${NMOS_CPP_DIR}/nmos/registry_persistence.cpp
+    ${NMOS_CPP_DIR}/nmos/registry_replica.cpp
     ${NMOS_CPP_DIR}/nmos/registry_resources.cpp
     ${NMOS_CPP_DIR}/nmos/registry_server.cpp
     ${NMOS_CPP_DIR}/nmos/resource.cpp
     ${NMOS_CPP_DIR}/nmos/resources.cpp
+    ${NMOS_CPP_DIR}/nmos/resources_snapshot.cpp
     ${NMOS_CPP_DIR}/nmos/sdp_utils.cpp
     ${NMOS_CPP_DIR}/nmos/server_utils.cpp
     ${NMOS_CPP_DIR}/nmos/settings.cpp
@@ -627,6 +633,7 @@ set(NMOS_CPP_NMOS_HEADERS
     ${NMOS_CPP_DIR}/nmos/event_type.h
     ${NMOS_CPP_DIR}/nmos/events_api.h
     ${NMOS_CPP_DIR}/nmos/events_resources.h
+    ${NMOS_CPP_DIR}/nmos/events_subscribers.h
     ${NMOS_CPP_DIR}/nmos/events_ws_api.h
     ${NMOS_CPP_DIR}/nmos/events_ws_client.h
     ${NMOS_CPP_DIR}/nmos/filesystem_route.h
@@ -648,7 +655,10 @@ set(NMOS_CPP_NMOS_HEADERS
     ${NMOS_CPP_DIR}/nmos/mdns.h
     ${NMOS_CPP_DIR}/nmos/mdns_api.h
     ${NMOS_CPP_DIR}/nmos/media_type.h
+    ${NMOS_CPP_DIR}/nmos/metrics.h
+    ${NMOS_CPP_DIR}/nmos/metrics_api.h
     ${NMOS_CPP_DIR}/nmos/model.h
+    ${NMOS_CPP_DIR}/nmos/model_transaction.h
     ${NMOS_CPP_DIR}/nmos/mutex.h
     ${NMOS_CPP_DIR}/nmos/node_api.h
     ${NMOS_CPP_DIR}/nmos/node_api_target_handler.h
@@ -664,10 +674,13 @@ set(NMOS_CPP_NMOS_HEADERS
     ${NMOS_CPP_DIR}/nmos/random.h
     ${NMOS_CPP_DIR}/nmos/rational.h
     ${NMOS_CPP_DIR}/nmos/registration_api.h
+    ${NMOS_CPP_DIR}/nmos/registry_persistence.h
+    ${NMOS_CPP_DIR}/nmos/registry_replica.h
     ${NMOS_CPP_DIR}/nmos/registry_resources.h
     ${NMOS_CPP_DIR}/nmos/registry_server.h
     ${NMOS_CPP_DIR}/nmos/resource.h
     ${NMOS_CPP_DIR}/nmos/resources.h
+    ${NMOS_CPP_DIR}/nmos/resources_snapshot.h
     ${NMOS_CPP_DIR}/nmos/sdp_utils.h
     ${NMOS_CPP_DIR}/nmos/server.h
     ${NMOS_CPP_DIR}/nmos/server_utils.h
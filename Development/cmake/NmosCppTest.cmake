@@ -39,9 +39,15 @@ set(NMOS_CPP_TEST_MDNS_TEST_HEADERS
 set(NMOS_CPP_TEST_NMOS_TEST_SOURCES
     ${NMOS_CPP_DIR}/nmos/test/api_utils_test.cpp
     ${NMOS_CPP_DIR}/nmos/test/event_type_test.cpp
+    ${NMOS_CPP_DIR}/nmos/test/events_subscribers_test.cpp
+    ${NMOS_CPP_DIR}/nmos/test/events_ws_client_test.cpp
+    ${NMOS_CPP_DIR}/nmos/test/model_transaction_test.cpp
     ${NMOS_CPP_DIR}/nmos/test/paging_utils_test.cpp
+    ${NMOS_CPP_DIR}/nmos/test/query_utils_test.cpp
+    ${NMOS_CPP_DIR}/nmos/test/resources_test.cpp
     )
 set(NMOS_CPP_TEST_NMOS_TEST_HEADERS
+    ${NMOS_CPP_DIR}/nmos/test/test_resources.h
     )
 
 set(NMOS_CPP_TEST_SDP_TEST_SOURCES
@@ -90,6 +96,12 @@ target_link_libraries(
     ${Boost_LIBRARIES}
     )
 
+# benchmarks, e.g. of message routing, SDP parsing and HTTP compression, are not built by default, since they are slow, and their timings are only informative
+set (NMOS_CPP_TEST_BENCHMARKS OFF CACHE BOOL "Build the benchmark test cases into nmos-cpp-test")
+if (NMOS_CPP_TEST_BENCHMARKS)
+    target_compile_definitions(nmos-cpp-test PRIVATE NMOS_CPP_TEST_BENCHMARKS)
+endif()
+
 include(Catch)
 
 catch_discover_tests(nmos-cpp-test EXTRA_ARGS -r compact)
@@ -32,6 +32,7 @@ namespace web
                 }
 
                 api_router::api_router()
+                    : context(std::make_shared<mount_context>())
                 {}
 
                 void api_router::operator()(web::http::http_request req)
@@ -78,8 +79,12 @@ namespace web
 
                             if (route->method == req.method() || any_method == route->method)
                             {
+                                const auto status_code = res.status_code();
+                                const auto start = std::chrono::steady_clock::now();
                                 return call(route->handler, exception_handler, req, res, merged_path, merged_parameters).then([=](bool continue_matching)
                                 {
+                                    record_statistics(*route, req, res, status_code, start);
+
                                     if (!continue_matching)
                                     {
                                         // short-circuit other routes, e.g. if the hander actually sent a reply rather than just modifying the response object
@@ -166,15 +171,51 @@ namespace web
                     insert(routes.end(), match_prefix, route_pattern, any_method, all_handler);
                 }
 
+                void api_router::mount(const utility::string_t& route_pattern, const web::http::method& method, api_router sub_router)
+                {
+                    sub_router.context->parent = context;
+                    sub_router.context->route_pattern = route_pattern;
+                    insert(routes.end(), match_prefix, route_pattern, method, sub_router);
+                }
+
+                void api_router::mount(const utility::string_t& route_pattern, api_router sub_router)
+                {
+                    mount(route_pattern, any_method, std::move(sub_router));
+                }
+
                 void api_router::set_exception_handler(route_handler handler)
                 {
                     exception_handler = handler;
                 }
 
+                void api_router::set_statistics_handler(route_statistics_handler statistics_handler)
+                {
+                    context->statistics_handler = statistics_handler;
+                }
+
+                void api_router::record_statistics(const route& route, const web::http::http_request& req, const web::http::http_response& res, web::http::status_code status_code, std::chrono::steady_clock::time_point start) const
+                {
+                    // only record routes that actually handle the request, i.e. that set the response status code, rather than mounted handlers,
+                    // or e.g. handlers that just validate the request and continue matching routes, or that just send the response
+                    if (match_entire != route.flags || empty_status_code == res.status_code() || status_code == res.status_code()) return;
+
+                    // the nearest statistics handler, and the entire route pattern, are found by following the chain of mount points
+                    const route_statistics_handler* statistics_handler = nullptr;
+                    utility::string_t route_pattern = route.pattern;
+                    for (auto mount = std::shared_ptr<const mount_context>(context); mount; mount = mount->parent)
+                    {
+                        if (!statistics_handler && mount->statistics_handler) statistics_handler = &mount->statistics_handler;
+                        route_pattern.insert(0, mount->route_pattern);
+                    }
+                    if (!statistics_handler) return;
+
+                    (*statistics_handler)(route_pattern, req.method(), res.status_code(), std::chrono::steady_clock::now() - start);
+                }
+
                 api_router::iterator api_router::insert(iterator where, match_flag_type flags, const utility::string_t& route_pattern, const web::http::method& method, route_handler handler)
                 {
                     auto parsed = utility::parse_regex_named_sub_matches(route_pattern);
-                    return routes.insert(where, { flags, { utility::regex_t(parsed.first), parsed.second }, method, handler });
+                    return routes.insert(where, { flags, { utility::regex_t(parsed.first), parsed.second }, method, handler, route_pattern });
                 }
 
                 route_parameters api_router::get_parameters(const utility::named_sub_matches_t& parameter_sub_matches, const utility::smatch_t& route_match)
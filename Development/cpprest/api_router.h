@@ -1,8 +1,10 @@
 #ifndef CPPREST_API_ROUTER_H
 #define CPPREST_API_ROUTER_H
 
+#include <chrono>
 #include <functional>
 #include <list>
+#include <memory>
 #include <unordered_map>
 #include "cpprest/http_utils.h"
 #include "cpprest/json_ops.h" // hmm, only for names used in using declarations
@@ -28,6 +30,11 @@ namespace web
                 // a handler may e.g. reply to the request or initiate asynchronous processing, and returns a flag indicating whether to continue matching routes or not
                 typedef std::function<pplx::task<bool>(web::http::http_request req, web::http::http_response res, const utility::string_t& route_path, const route_parameters& parameters)> route_handler;
 
+                // route statistics handlers are called by an api_router to record the latency of each request per route pattern, method and status code
+                // the route pattern is the concatenation of the patterns of the route and those of any api_router within which it is mounted
+                // (the handler may be called concurrently, so must be thread-safe)
+                typedef std::function<void(const utility::string_t& route_pattern, const web::http::method& method, web::http::status_code status_code, std::chrono::steady_clock::duration duration)> route_statistics_handler;
+
                 class api_router
                 {
                     DETAIL_PRIVATE_ACCESS_DECLARATION
@@ -49,13 +56,22 @@ namespace web
                     // add a handler to support all other requests for this route and sub-routes (must be added after any method-specific handlers)
                     void mount(const utility::string_t& route_pattern, route_handler all_handler);
 
+                    // mount another api_router, which allows its routes to be recorded in this api_router's statistics
+                    // (the mounted api_router, and any copies of it, must not be mounted elsewhere)
+                    void mount(const utility::string_t& route_pattern, const web::http::method& method, api_router sub_router);
+                    void mount(const utility::string_t& route_pattern, api_router sub_router);
+
+                    // record statistics for the requests handled by the routes of this api_router and any mounted api_router
+                    // when each route handler completes, if it has set (or changed) the response status code
+                    void set_statistics_handler(route_statistics_handler statistics_handler);
+
                     // provide an exception handler for this route and sub-routes (using std::current_exception, etc.)
                     void set_exception_handler(route_handler handler);
 
                 private:
                     enum match_flag_type { match_entire = 0, match_prefix = 1 };
                     typedef std::pair<utility::regex_t, utility::named_sub_matches_t> regex_named_sub_matches_type;
-                    struct route { match_flag_type flags; regex_named_sub_matches_type route_pattern; web::http::method method; route_handler handler; };
+                    struct route { match_flag_type flags; regex_named_sub_matches_type route_pattern; web::http::method method; route_handler handler; utility::string_t pattern; };
                     typedef std::list<route> route_handlers;
                     typedef route_handlers::iterator iterator;
 
@@ -66,6 +82,16 @@ namespace web
                     static route_parameters insert(route_parameters&& into, const route_parameters& range);
                     static bool route_regex_match(const utility::string_t& path, utility::smatch_t& route_match, const utility::regex_t& route_regex, match_flag_type flags);
 
+                    // the statistics handler and the route pattern at which this api_router is mounted are shared by all copies of it
+                    struct mount_context
+                    {
+                        route_statistics_handler statistics_handler;
+                        std::shared_ptr<const mount_context> parent;
+                        utility::string_t route_pattern;
+                    };
+
+                    void record_statistics(const route& route, const web::http::http_request& req, const web::http::http_response& res, web::http::status_code status_code, std::chrono::steady_clock::time_point start) const;
+
                     pplx::task<bool> operator()(web::http::http_request req, web::http::http_response res, const utility::string_t& route_path, const route_parameters& parameters, iterator route);
 
                     // to allow routes to be added out-of-order, support() and mount() could easily be given overloads that accept and return an iterator (const_iterator in C++11)
@@ -73,6 +99,7 @@ namespace web
 
                     route_handlers routes;
                     route_handler exception_handler;
+                    std::shared_ptr<mount_context> context;
                 };
 
                 // convenient using declarations to make defining routers less verbose
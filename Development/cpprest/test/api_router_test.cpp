@@ -1,6 +1,8 @@
 // The first "test" is of course whether the header compiles standalone
 #include "cpprest/api_router.h"
 
+#include <tuple>
+#include <vector>
 #include "bst/test/test.h"
 #include "cpprest/basic_utils.h" // for utility::us2s, utility::s2us
 
@@ -88,3 +90,42 @@ BST_TEST_CASE_PRIVATE(testGetParameters)
     BST_REQUIRE(bst::regex_match(path, route_match, route_regex));
     BST_REQUIRE(expected == api_router::get_parameters(parameter_sub_matches, route_match));
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testRouteStatistics)
+{
+    using namespace web::http::experimental::listener::api_router_using_declarations;
+
+    api_router inner;
+    inner.support(U("/bar/(?<id>[0-9]+)/?"), methods::GET, [](http_request, http_response res, const string_t&, const route_parameters&)
+    {
+        set_reply(res, status_codes::OK);
+        return pplx::task_from_result(true);
+    });
+    // a handler that doesn't change the status code isn't recorded
+    inner.support(U("/bar/.*"), [](http_request, http_response, const string_t&, const route_parameters&)
+    {
+        return pplx::task_from_result(true);
+    });
+
+    api_router outer;
+    outer.mount(U("/foo"), inner);
+
+    // statistics may be enabled after mounting
+    std::vector<std::tuple<utility::string_t, web::http::method, web::http::status_code>> recorded;
+    outer.set_statistics_handler([&recorded](const string_t& route_pattern, const web::http::method& method, web::http::status_code status_code, std::chrono::steady_clock::duration)
+    {
+        recorded.push_back(std::make_tuple(route_pattern, method, status_code));
+    });
+
+    web::http::http_request req(methods::GET);
+    req.set_request_uri(web::uri(U("http://host:123/foo/bar/42")));
+    web::http::http_response res;
+    BST_REQUIRE(outer(req, res, {}, {}).get());
+    BST_REQUIRE_EQUAL(status_codes::OK, res.status_code());
+
+    BST_REQUIRE_EQUAL(1, recorded.size());
+    BST_REQUIRE_STRING_EQUAL("/foo/bar/(?<id>[0-9]+)/?", utility::us2s(std::get<0>(recorded.front())));
+    BST_REQUIRE_STRING_EQUAL("GET", utility::us2s(std::get<1>(recorded.front())));
+    BST_REQUIRE_EQUAL(status_codes::OK, std::get<2>(recorded.front()));
+}
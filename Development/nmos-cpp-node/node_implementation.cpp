@@ -7,6 +7,7 @@
 #include "nmos/group_hint.h"
 #include "nmos/media_type.h"
 #include "nmos/model.h"
+#include "nmos/model_transaction.h"
 #include "nmos/node_resource.h"
 #include "nmos/node_resources.h"
 #include "nmos/random.h"
@@ -43,27 +44,28 @@ void node_implementation_thread(nmos::node_model& model, slog::base_gate& gate_)
     auto temperature_ws_sender_id = nmos::make_repeatable_id(seed_id, U("/x-nmos/node/sender/1"));
     auto temperature_ws_receiver_id = nmos::make_repeatable_id(seed_id, U("/x-nmos/node/receiver/1"));
 
-    // any delay between updates to the model resources is unnecessary
+    // any delay before updating the model resources is unnecessary
     // this just serves as a slightly more realistic example!
     const unsigned int delay_millis{ 10 };
 
+    if (nmos::details::wait_for(model.shutdown_condition, lock, std::chrono::milliseconds(delay_millis), [&] { return model.shutdown; })) return;
+
     // it is important that the model be locked before inserting, updating or deleting a resource
     // and that the the node behaviour thread be notified after doing so
-    const auto insert_resource_after = [&model, &lock](unsigned int milliseconds, nmos::resources& resources, nmos::resource&& resource, slog::base_gate& gate)
-    {
-        if (nmos::details::wait_for(model.shutdown_condition, lock, std::chrono::milliseconds(milliseconds), [&] { return model.shutdown; })) return false;
+    // the transaction does both, holding the lock for all the changes and notifying just once when it is committed,
+    // so that the node behaviour thread (and anyone else who cares...) handles all the resource events together
+    nmos::experimental::node_model_transaction transaction(model, lock);
 
+    const auto insert_resource_in_transaction = [&transaction](nmos::resources& resources, nmos::resource&& resource, slog::base_gate& gate)
+    {
         const std::pair<nmos::id, nmos::type> id_type{ resource.id, resource.type };
-        const bool success = insert_resource(resources, std::move(resource)).second;
+        const bool success = transaction.insert(resources, std::move(resource));
 
         if (success)
             slog::log<slog::severities::info>(gate, SLOG_FLF) << "Updated model with " << id_type;
         else
             slog::log<slog::severities::severe>(gate, SLOG_FLF) << "Model update error: " << id_type;
 
-        slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying node behaviour thread"; // and anyone else who cares...
-        model.notify();
-
         return success;
     };
 
@@ -81,7 +83,7 @@ void node_implementation_thread(nmos::node_model& model, slog::base_gate& gate_)
                 { U("name"), U("example") }
             })
         });
-        if (!insert_resource_after(delay_millis, model.node_resources, std::move(node), gate)) return;
+        if (!insert_resource_in_transaction(model.node_resources, std::move(node), gate)) return;
     }
 
     // example device
@@ -90,7 +92,7 @@ void node_implementation_thread(nmos::node_model& model, slog::base_gate& gate_)
             ? std::vector<nmos::id>{ sender_id, temperature_ws_sender_id }
             : std::vector<nmos::id>{ sender_id };
         const auto receivers = std::vector<nmos::id>{ receiver_id, temperature_ws_receiver_id };
-        if (!insert_resource_after(delay_millis, model.node_resources, nmos::make_device(device_id, node_id, senders, receivers, model.settings), gate)) return;
+        if (!insert_resource_in_transaction(model.node_resources, nmos::make_device(device_id, node_id, senders, receivers, model.settings), gate)) return;
     }
 
     // example source, flow and sender
@@ -100,8 +102,8 @@ void node_implementation_thread(nmos::node_model& model, slog::base_gate& gate_)
         auto flow = nmos::make_raw_video_flow(flow_id, source_id, device_id, model.settings);
 
         // set_transportfile needs to find the matching source and flow for the sender, so insert these first
-        if (!insert_resource_after(delay_millis, model.node_resources, std::move(source), gate)) return;
-        if (!insert_resource_after(delay_millis, model.node_resources, std::move(flow), gate)) return;
+        if (!insert_resource_in_transaction(model.node_resources, std::move(source), gate)) return;
+        if (!insert_resource_in_transaction(model.node_resources, std::move(flow), gate)) return;
 
         // add example network interface binding for both primary and secondary
         auto sender = nmos::make_sender(sender_id, flow_id, device_id, { U("example"), U("example") }, model.settings);
@@ -112,8 +114,8 @@ void node_implementation_thread(nmos::node_model& model, slog::base_gate& gate_)
         resolve_auto(sender, connection_sender, connection_sender.data[nmos::fields::endpoint_active][nmos::fields::transport_params]);
         set_transportfile(sender, connection_sender, connection_sender.data[nmos::fields::endpoint_transportfile]);
 
-        if (!insert_resource_after(delay_millis, model.node_resources, std::move(sender), gate)) return;
-        if (!insert_resource_after(delay_millis, model.connection_resources, std::move(connection_sender), gate)) return;
+        if (!insert_resource_in_transaction(model.node_resources, std::move(sender), gate)) return;
+        if (!insert_resource_in_transaction(model.connection_resources, std::move(connection_sender), gate)) return;
     }
 
     // example receiver
@@ -126,8 +128,8 @@ void node_implementation_thread(nmos::node_model& model, slog::base_gate& gate_)
         auto connection_receiver = nmos::make_connection_rtp_receiver(receiver_id, true);
         resolve_auto(receiver, connection_receiver, connection_receiver.data[nmos::fields::endpoint_active][nmos::fields::transport_params]);
 
-        if (!insert_resource_after(delay_millis, model.node_resources, std::move(receiver), gate)) return;
-        if (!insert_resource_after(delay_millis, model.connection_resources, std::move(connection_receiver), gate)) return;
+        if (!insert_resource_in_transaction(model.node_resources, std::move(receiver), gate)) return;
+        if (!insert_resource_in_transaction(model.connection_resources, std::move(connection_receiver), gate)) return;
     }
 
     // example temperature event source, sender, flow
@@ -148,11 +150,11 @@ void node_implementation_thread(nmos::node_model& model, slog::base_gate& gate_)
         auto connection_temperature_ws_sender = nmos::make_connection_events_websocket_sender(temperature_ws_sender_id, device_id, temperature_source_id, model.settings);
         resolve_auto(temperature_ws_sender, connection_temperature_ws_sender, connection_temperature_ws_sender.data[nmos::fields::endpoint_active][nmos::fields::transport_params]);
 
-        if (!insert_resource_after(delay_millis, model.node_resources, std::move(temperature_source), gate)) return;
-        if (!insert_resource_after(delay_millis, model.node_resources, std::move(temperature_flow), gate)) return;
-        if (!insert_resource_after(delay_millis, model.node_resources, std::move(temperature_ws_sender), gate)) return;
-        if (!insert_resource_after(delay_millis, model.connection_resources, std::move(connection_temperature_ws_sender), gate)) return;
-        if (!insert_resource_after(delay_millis, model.events_resources, std::move(events_temperature_source), gate)) return;
+        if (!insert_resource_in_transaction(model.node_resources, std::move(temperature_source), gate)) return;
+        if (!insert_resource_in_transaction(model.node_resources, std::move(temperature_flow), gate)) return;
+        if (!insert_resource_in_transaction(model.node_resources, std::move(temperature_ws_sender), gate)) return;
+        if (!insert_resource_in_transaction(model.connection_resources, std::move(connection_temperature_ws_sender), gate)) return;
+        if (!insert_resource_in_transaction(model.events_resources, std::move(events_temperature_source), gate)) return;
     }
 
     // example temperature event receiver
@@ -163,10 +165,13 @@ void node_implementation_thread(nmos::node_model& model, slog::base_gate& gate_)
         auto connection_temperature_receiver = nmos::make_connection_events_websocket_receiver(temperature_ws_receiver_id, model.settings);
         resolve_auto(temperature_receiver, connection_temperature_receiver, connection_temperature_receiver.data[nmos::fields::endpoint_active][nmos::fields::transport_params]);
 
-        if (!insert_resource_after(delay_millis, model.node_resources, std::move(temperature_receiver), gate)) return;
-        if (!insert_resource_after(delay_millis, model.connection_resources, std::move(connection_temperature_receiver), gate)) return;
+        if (!insert_resource_in_transaction(model.node_resources, std::move(temperature_receiver), gate)) return;
+        if (!insert_resource_in_transaction(model.connection_resources, std::move(connection_temperature_receiver), gate)) return;
     }
 
+    slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying node behaviour thread"; // and anyone else who cares...
+    transaction.commit();
+
     // start background tasks to intermittently update the state of the temperature event source, to cause events to be emitted to connected receivers
 
     nmos::details::seed_generator temperature_interval_seeder;
@@ -68,6 +68,36 @@ namespace nmos
         return downgrade(resource.version, resource.downgrade_version, resource.type, resource.data, version, downgrade_version);
     }
 
+    std::shared_ptr<const utility::string_t> serialize_downgrade(const nmos::resource& resource, const nmos::api_version& version)
+    {
+        return serialize_downgrade(resource, version, version);
+    }
+
+    std::shared_ptr<const utility::string_t> serialize_downgrade(const nmos::resource& resource, const nmos::api_version& version, const nmos::api_version& downgrade_version)
+    {
+        // not cached, since this is not expected to be a common case
+        if (!is_permitted_downgrade(resource, version, downgrade_version)) return std::make_shared<const utility::string_t>(web::json::value::null().serialize());
+
+        // the resource data is returned unmodified when the requested version is the same or higher, so share that serialization
+        if (resource.version <= version) return details::serialize(resource);
+
+        return resource.serialized.get(version, resource.updated, [&]
+        {
+            return downgrade(resource, version, downgrade_version).serialize();
+        });
+    }
+
+    namespace details
+    {
+        std::shared_ptr<const utility::string_t> serialize(const nmos::resource& resource)
+        {
+            return resource.serialized.get(resource.version, resource.updated, [&]
+            {
+                return resource.data.serialize();
+            });
+        }
+    }
+
     static const std::map<nmos::type, std::map<nmos::api_version, std::vector<utility::string_t>>>& resources_versions()
     {
         static const std::map<nmos::type, std::map<nmos::api_version, std::vector<utility::string_t>>> resources_versions
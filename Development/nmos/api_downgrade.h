@@ -1,6 +1,8 @@
 #ifndef NMOS_API_DOWNGRADE_H
 #define NMOS_API_DOWNGRADE_H
 
+#include <memory>
+#include <vector>
 #include "cpprest/json.h"
 
 // "Downgrade queries permit old-versioned responses to be provided to clients which are confident
@@ -27,6 +29,44 @@ namespace nmos
     web::json::value downgrade(const nmos::resource& resource, const nmos::api_version& version);
     web::json::value downgrade(const nmos::resource& resource, const nmos::api_version& version, const nmos::api_version& downgrade_version);
     web::json::value downgrade(const nmos::api_version& resource_version, const nmos::api_version& resource_downgrade_version, const nmos::type& resource_type, const web::json::value& resource_data, const nmos::api_version& version, const nmos::api_version& downgrade_version);
+
+    // serialized equivalents of downgrade, which are cached in the resource until it is next updated
+    // (the caller must hold at least a read lock on the model mutex)
+    std::shared_ptr<const utility::string_t> serialize_downgrade(const nmos::resource& resource, const nmos::api_version& version);
+    std::shared_ptr<const utility::string_t> serialize_downgrade(const nmos::resource& resource, const nmos::api_version& version, const nmos::api_version& downgrade_version);
+
+    namespace details
+    {
+        // serialized resource data, without any downgrade, which is also cached in the resource until it is next updated
+        std::shared_ptr<const utility::string_t> serialize(const nmos::resource& resource);
+
+        // filter and transform a forward range of resources into serialized fragments, e.g. using serialize_downgrade, and concatenate them as a json array
+        template <typename ForwardRange, typename Pred, typename Serialize>
+        inline utility::string_t serialize_array_if(const ForwardRange& range, Pred pred, Serialize serialize)
+        {
+            std::vector<std::shared_ptr<const utility::string_t>> fragments;
+            size_t size = 2;
+            for (auto& element : range)
+            {
+                if (pred(element))
+                {
+                    fragments.push_back(serialize(element));
+                    size += fragments.back()->size() + 1;
+                }
+            }
+
+            utility::string_t result;
+            result.reserve(size);
+            result.push_back(_XPLATSTR('['));
+            for (auto& fragment : fragments)
+            {
+                if (&fragment != &fragments.front()) result.push_back(_XPLATSTR(','));
+                result.append(*fragment);
+            }
+            result.push_back(_XPLATSTR(']'));
+            return result;
+        }
+    }
 }
 
 #endif
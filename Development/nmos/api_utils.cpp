@@ -1,15 +1,22 @@
 #include "nmos/api_utils.h"
 
 #include <boost/algorithm/cxx11/any_of.hpp>
+#include <boost/algorithm/string/case_conv.hpp>
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/range/adaptor/transformed.hpp>
+#include "cpprest/http_compression.h"
 #include "cpprest/json_visit.h"
+#include "cpprest/producerconsumerstream.h"
 #include "cpprest/uri_schemes.h"
 #include "cpprest/ws_utils.h"
 #include "nmos/api_version.h"
+#include "nmos/resource.h"
 #include "nmos/slog.h"
 #include "nmos/type.h"
+#include "nmos/version.h"
+#include "pplx/pplx_utils.h"
 
 namespace web
 {
@@ -430,6 +437,161 @@ namespace nmos
         }
     }
 
+    // experimental extensions, to support conditional requests, and to compress HTTP response bodies using "gzip" or "deflate" Content-Encoding,
+    // if supported by the C++ REST SDK
+    namespace experimental
+    {
+        // negotiate a supported content coding from the request's Accept-Encoding header, or return an empty string for "identity"
+        // see https://tools.ietf.org/html/rfc7231#section-5.3.4
+        utility::string_t negotiate_content_encoding(const web::http::http_request& req)
+        {
+            if (!web::http::compression::builtin::supported()) return{};
+
+            utility::string_t accept_encoding;
+            if (!req.headers().match(web::http::header_names::accept_encoding, accept_encoding)) return{};
+
+            // e.g. "gzip, deflate;q=0.5, *;q=0"
+            std::map<utility::string_t, double> qvalues;
+            std::vector<utility::string_t> codings;
+            boost::algorithm::split(codings, accept_encoding, [](utility::char_t c) { return U(',') == c; });
+            for (const auto& coding : codings)
+            {
+                std::vector<utility::string_t> params;
+                boost::algorithm::split(params, coding, [](utility::char_t c) { return U(';') == c; });
+                double qvalue = 1.0;
+                for (auto param = std::next(params.begin()); params.end() != param; ++param)
+                {
+                    const auto trimmed = boost::algorithm::trim_copy(*param);
+                    if (!boost::algorithm::istarts_with(trimmed, U("q="))) continue;
+                    utility::istringstream_t is(trimmed.substr(2));
+                    if (!(is >> qvalue)) qvalue = 0.0;
+                }
+                qvalues[boost::algorithm::to_lower_copy(boost::algorithm::trim_copy(params.front()))] = qvalue;
+            }
+
+            // prefer gzip, since some clients handle raw deflate streams and zlib-wrapped ones inconsistently
+            utility::string_t result;
+            double best = 0.0;
+            for (const auto& candidate : { utility::string_t(web::http::compression::builtin::algorithm::GZIP), utility::string_t(web::http::compression::builtin::algorithm::DEFLATE) })
+            {
+                auto found = qvalues.find(candidate);
+                if (qvalues.end() == found) found = qvalues.find(U("*"));
+                const double qvalue = qvalues.end() != found ? found->second : 0.0;
+                if (qvalue > best && web::http::compression::builtin::algorithm::supported(candidate))
+                {
+                    result = candidate;
+                    best = qvalue;
+                }
+            }
+            return result;
+        }
+
+        // compress the specified data using the specified content coding
+        std::vector<uint8_t> compress(const utility::string_t& content_encoding, const uint8_t* data, size_t size)
+        {
+            auto compressor = web::http::compression::builtin::make_compressor(content_encoding);
+            if (!compressor) throw std::invalid_argument("unsupported content coding");
+
+            std::vector<uint8_t> result;
+            size_t processed = 0;
+            bool done = false;
+            while (!done)
+            {
+                // JSON typically compresses well, so start small, and grow the output as required
+                const size_t chunk = (std::max)(size / 4, size_t(256));
+                const auto produced = result.size();
+                result.resize(produced + chunk);
+                // the built-in compressors complete synchronously
+                const auto op = compressor->compress(data + processed, size - processed, result.data() + produced, chunk, web::http::compression::operation_hint::is_last).get();
+                processed += op.input_bytes_processed;
+                result.resize(produced + op.output_bytes_produced);
+                done = op.done;
+            }
+            return result;
+        }
+
+        // make a strong entity-tag for a resource, from its update timestamp (which is unique, since it is strictly increasing)
+        utility::string_t make_etag(const nmos::tai& updated)
+        {
+            return U("\"") + nmos::make_version(updated) + U("\"");
+        }
+
+        // make a strong entity-tag for a page of resources, from the paging parameters that are returned in the X-Paging-Since and X-Paging-Until headers
+        // and the number of resources in the page, and optionally the generation of the resources (see nmos::resources), since expiry doesn't change the paging parameters
+        utility::string_t make_etag(const nmos::tai& since, const nmos::tai& until, size_t count, std::uint64_t generation)
+        {
+            utility::ostringstream_t os;
+            os << U('"') << nmos::make_version(since) << U('_') << nmos::make_version(until) << U('_') << count;
+            if (0 != generation) os << U('_') << generation;
+            os << U('"');
+            return os.str();
+        }
+
+        namespace details
+        {
+            // a compressed representation has a distinct entity-tag, with the content coding appended to the opaque-tag
+            // see https://tools.ietf.org/html/rfc7232#section-2.3.3
+            utility::string_t make_content_encoding_etag(const utility::string_t& etag, const utility::string_t& content_encoding)
+            {
+                if (etag.size() < 2 || U('"') != etag.back()) return etag;
+                return etag.substr(0, etag.size() - 1) + U('-') + content_encoding + U('"');
+            }
+
+            // likewise, the human-readable HTML rendering of a JSON response has a distinct entity-tag, with "html" appended to the opaque-tag,
+            // since it is a different representation, and a cache must not use one in place of the other
+            const utility::string_t html_representation{ U("html") };
+
+            // the entity-tag of the representation which will be sent in response to the specified request, given the entity-tag of the JSON representation
+            utility::string_t make_representation_etag(const web::http::http_request& req, const utility::string_t& etag)
+            {
+                return is_html_response_preferred(req, web::http::details::mime_types::application_json)
+                    ? make_content_encoding_etag(etag, html_representation)
+                    : etag;
+            }
+
+            void set_compressed_body(web::http::http_response& res, std::vector<uint8_t> compressed, const utility::string_t& content_encoding)
+            {
+                const auto content_type = res.headers().content_type();
+                const auto size = compressed.size();
+                res.set_body(concurrency::streams::bytestream::open_istream(std::move(compressed)), size, content_type);
+                res.headers().set(web::http::header_names::content_encoding, content_encoding);
+
+                // the content coding is appended to the entity-tag of the representation, including the "-html" suffix of an HTML rendering
+                utility::string_t etag;
+                if (res.headers().match(web::http::header_names::etag, etag))
+                {
+                    res.headers().set(web::http::header_names::etag, make_content_encoding_etag(etag, content_encoding));
+                }
+            }
+        }
+
+        // determine whether the request's If-None-Match header matches the specified entity-tag, i.e. whether a 304 Not Modified response should be sent
+        // see https://tools.ietf.org/html/rfc7232#section-3.2
+        bool is_not_modified(const web::http::http_request& req, const utility::string_t& etag)
+        {
+            utility::string_t if_none_match;
+            if (!req.headers().match(web::http::header_names::if_none_match, if_none_match)) return false;
+
+            // "A recipient MUST use the weak comparison function when comparing entity-tags for If-None-Match"
+            // and any of the compressed representations are equivalent for this purpose, but the JSON and HTML representations are not
+            const auto representation_etag = details::make_representation_etag(req, etag);
+            std::vector<utility::string_t> entity_tags;
+            boost::algorithm::split(entity_tags, if_none_match, [](utility::char_t c) { return U(',') == c; });
+            for (auto& entity_tag : entity_tags)
+            {
+                boost::algorithm::trim(entity_tag);
+                if (U("*") == entity_tag) return true;
+                if (boost::algorithm::starts_with(entity_tag, U("W/"))) entity_tag.erase(0, 2);
+                if (representation_etag == entity_tag) return true;
+                for (const auto& content_encoding : { utility::string_t(web::http::compression::builtin::algorithm::GZIP), utility::string_t(web::http::compression::builtin::algorithm::DEFLATE) })
+                {
+                    if (details::make_content_encoding_etag(representation_etag, content_encoding) == entity_tag) return true;
+                }
+            }
+            return false;
+        }
+    }
+
     namespace details
     {
         // make user error information (to be used with status_codes::NotFound)
@@ -459,25 +621,43 @@ namespace nmos
 
         static const utility::string_t actual_method{ U("X-Actual-Method") };
 
+        // compress the response body, if it is at least the specified threshold size and the request permits a supported content coding
+        static void compress_response_body(const web::http::http_request& req, web::http::http_response& res, int compression_threshold)
+        {
+            // since the Accept-Encoding request header may affect the response, indicate that it should be taken into account
+            // when deciding whether or not a cached response can be used
+            res.headers().add(web::http::header_names::vary, web::http::header_names::accept_encoding);
+
+            // bodies which have already been compressed (see nmos::experimental::set_cached_reply), or which are being streamed
+            // without a Content-Length (see nmos::set_reply_json_array), are left alone
+            if (web::http::has_header_value(req.headers(), actual_method, web::http::methods::HEAD)) return;
+            if (!res.body() || res.headers().has(web::http::header_names::content_encoding)) return;
+            utility::size64_t content_length = 0;
+            if (!res.headers().match(web::http::header_names::content_length, content_length)) return;
+            if (content_length < (utility::size64_t)compression_threshold) return;
+
+            const auto content_encoding = nmos::experimental::negotiate_content_encoding(req);
+            if (content_encoding.empty()) return;
+
+            const auto body = res.extract_vector().get();
+            nmos::experimental::details::set_compressed_body(res, nmos::experimental::compress(content_encoding, body.data(), body.size()), content_encoding);
+        }
+
         // make handler to set appropriate response headers, and error response body if indicated
-        web::http::experimental::listener::route_handler make_api_finally_handler(slog::base_gate& gate_)
+        web::http::experimental::listener::route_handler make_api_finally_handler(slog::base_gate& gate)
+        {
+            return make_api_finally_handler(-1, gate);
+        }
+
+        // make handler to set appropriate response headers, and error response body if indicated, and to compress response bodies of at least the specified threshold size
+        web::http::experimental::listener::route_handler make_api_finally_handler(int compression_threshold, slog::base_gate& gate_)
         {
             using namespace web::http::experimental::listener::api_router_using_declarations;
 
-            return [&gate_](http_request req, http_response res, const string_t&, const route_parameters& parameters)
+            return [compression_threshold, &gate_](http_request req, http_response res, const string_t&, const route_parameters& parameters)
             {
                 nmos::api_gate gate(gate_, req, parameters);
 
-                // if it was a HEAD request, restore that and discard any response body
-                // since RFC 7231 says "the server MUST NOT send a message body in the response"
-                // see https://tools.ietf.org/html/rfc7231#section-4.3.2
-                if (web::http::has_header_value(req.headers(), actual_method, methods::HEAD))
-                {
-                    req.set_method(methods::HEAD);
-                    req.headers().remove(actual_method);
-                    if (res.body()) res.body() = concurrency::streams::bytestream::open_istream(std::vector<unsigned char>{});
-                }
-
                 if (web::http::empty_status_code == res.status_code())
                 {
                     res.set_status_code(status_codes::NotFound);
@@ -543,6 +723,33 @@ namespace nmos
                     res.headers().set_content_type(U("text/html; charset=utf-8"));
                 }
 
+                // the entity-tag of a JSON response identifies the HTML rendering of it, or a 304 Not Modified response to a request for that,
+                // by a distinct entity-tag, as does nmos::experimental::is_not_modified (the Vary header above indicates it depends on the Accept header)
+                utility::string_t etag;
+                if ((web::http::details::mime_types::application_json == mime_type || web::http::status_codes::NotModified == res.status_code())
+                    && res.headers().match(web::http::header_names::etag, etag))
+                {
+                    res.headers().set(web::http::header_names::etag, experimental::details::make_representation_etag(req, etag));
+                }
+
+                // experimental extension, to compress response bodies when the request permits
+
+                if (0 <= compression_threshold)
+                {
+                    compress_response_body(req, res, compression_threshold);
+                }
+
+                // if it was a HEAD request, restore that and discard any response body, which is done last so that the handling above
+                // can identify a HEAD request by the actual_method header
+                // since RFC 7231 says "the server MUST NOT send a message body in the response"
+                // see https://tools.ietf.org/html/rfc7231#section-4.3.2
+                if (web::http::has_header_value(req.headers(), actual_method, methods::HEAD))
+                {
+                    req.set_method(methods::HEAD);
+                    req.headers().remove(actual_method);
+                    if (res.body()) res.body() = concurrency::streams::bytestream::open_istream(std::vector<unsigned char>{});
+                }
+
                 slog::detail::logw<slog::log_statement, slog::base_gate>(gate, slog::severities::more_info, SLOG_FLF) << nmos::stash_categories({ nmos::categories::access }) << nmos::common_log_stash(req, res) << "Sending response";
 
                 req.reply(res);
@@ -565,12 +772,228 @@ namespace nmos
         set_error_reply(res, code, {}, utility::s2us(debug.what()));
     }
 
+    namespace details
+    {
+        // JSON array bodies up to this size are sent in one piece, with a Content-Length
+        const size_t json_array_streaming_threshold = 64 * 1024;
+        // elements are only written to a streamed body while less than this is waiting to be consumed
+        const size_t json_array_streaming_high_water = 256 * 1024;
+
+        // a producer-consumer buffer which can tell the producer when the consumer has read enough that it is below the high-water mark,
+        // so that however slowly the client reads the response, the memory held for it is bounded
+        class json_array_buffer : public concurrency::streams::details::basic_producer_consumer_buffer<uint8_t>
+        {
+        public:
+            json_array_buffer() : basic_producer_consumer_buffer<uint8_t>(512) {}
+
+            // the returned task results in true when the producer can write more, or false if the consumer has closed the buffer
+            pplx::task<bool> drained()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!can_read()) return pplx::task_from_result(false);
+                if (in_avail() < json_array_streaming_high_water) return pplx::task_from_result(true);
+                drained_event = pplx::task_completion_event<bool>();
+                return pplx::create_task(drained_event);
+            }
+
+        protected:
+            virtual pplx::task<size_t> _getn(uint8_t* ptr, size_t count)
+            {
+                auto self = std::static_pointer_cast<json_array_buffer>(shared_from_this());
+                return basic_producer_consumer_buffer<uint8_t>::_getn(ptr, count).then([self](size_t read)
+                {
+                    self->notify(true);
+                    return read;
+                });
+            }
+
+            virtual size_t _sgetn(uint8_t* ptr, size_t count)
+            {
+                const auto read = basic_producer_consumer_buffer<uint8_t>::_sgetn(ptr, count);
+                notify(true);
+                return read;
+            }
+
+            virtual pplx::task<void> _close_read()
+            {
+                auto result = basic_producer_consumer_buffer<uint8_t>::_close_read();
+                notify(false);
+                return result;
+            }
+
+        private:
+            void notify(bool more)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!more || in_avail() < json_array_streaming_high_water) drained_event.set(more);
+            }
+
+            std::mutex mutex;
+            pplx::task_completion_event<bool> drained_event;
+        };
+
+        struct json_array_stream
+        {
+            // the response body holds the only strong reference to the buffer, so that if it is discarded without being read,
+            // the buffer, and the producer waiting for it to be drained, are released
+            std::weak_ptr<json_array_buffer> buffer;
+            std::vector<std::shared_ptr<const utility::string_t>> elements;
+            size_t next;
+            // the UTF-8 encoding of the element being written, with its separator, which must remain valid until the write is complete
+            std::string chunk;
+        };
+
+        // write the next element of the array, preceded by the opening bracket or a separator, and followed by the closing bracket if it is the last,
+        // and sync the buffer so it can be consumed; the returned task is a continuation of the buffer's own tasks, and results in true if there are more
+        // elements to write, once the consumer has drained the buffer below the high-water mark, or false once the last has been written, or the buffer
+        // has stopped accepting writes, e.g. because the client has gone away
+        pplx::task<bool> write_next_json_array_element(std::shared_ptr<json_array_stream> stream)
+        {
+            auto buffer = stream->buffer.lock();
+            if (!buffer) return pplx::task_from_result(false);
+
+            stream->chunk.assign(0 == stream->next ? "[" : ",");
+            stream->chunk.append(utility::conversions::to_utf8string(*stream->elements[stream->next]));
+            // release each element as soon as it has been encoded
+            stream->elements[stream->next++].reset();
+            const bool more = stream->elements.size() != stream->next;
+            if (!more) stream->chunk.push_back(']');
+
+            const auto size = stream->chunk.size();
+            return buffer->putn_nocopy((const uint8_t*)stream->chunk.data(), size).then([stream, size, more](size_t written) -> pplx::task<bool>
+            {
+                auto buffer = stream->buffer.lock();
+                if (!buffer || size != written) return pplx::task_from_result(false);
+                return buffer->sync().then([stream, more]() -> pplx::task<bool>
+                {
+                    auto buffer = stream->buffer.lock();
+                    if (!buffer || !more) return pplx::task_from_result(false);
+                    return buffer->drained();
+                });
+            });
+        }
+    }
+
+    // set up a response with a JSON array body, assembled from the specified serialized elements (e.g. see nmos::serialize_downgrade)
+    void set_reply_json_array(const web::http::http_request& req, web::http::http_response& res, web::http::status_code code, std::vector<std::shared_ptr<const utility::string_t>> elements)
+    {
+        size_t size = 2;
+        for (const auto& element : elements) size += element->size() + 1;
+
+        // small bodies, and responses to HEAD requests, for which the body will be discarded (see make_api_finally_handler), are not streamed
+        if (size <= details::json_array_streaming_threshold || web::http::has_header_value(req.headers(), details::actual_method, web::http::methods::HEAD))
+        {
+            utility::string_t body;
+            body.reserve(size);
+            body.push_back(_XPLATSTR('['));
+            for (const auto& element : elements)
+            {
+                if (&element != &elements.front()) body.push_back(_XPLATSTR(','));
+                body.append(*element);
+            }
+            body.push_back(_XPLATSTR(']'));
+            set_reply(res, code, body, web::http::details::mime_types::application_json);
+            return;
+        }
+
+        auto buffer = std::make_shared<details::json_array_buffer>();
+        auto stream = std::make_shared<details::json_array_stream>();
+        stream->buffer = buffer;
+        stream->elements = std::move(elements);
+        stream->next = 0;
+
+        // without a Content-Length, the response body is sent using chunked transfer encoding
+        set_reply(res, code, concurrency::streams::streambuf<uint8_t>(buffer).create_istream(), web::http::details::mime_types::application_json);
+
+        pplx::do_while([stream]() -> pplx::task<bool>
+        {
+            return details::write_next_json_array_element(stream);
+        }).then([stream](pplx::task<void> finally)
+        {
+            stream->elements.clear();
+            auto buffer = stream->buffer.lock();
+            if (buffer) buffer->close(std::ios_base::out);
+            pplx::observe_exception<void>()(finally);
+        });
+    }
+
+    namespace experimental
+    {
+        // set up a response with a serialized JSON body from the resource's cache (see nmos::serialize_downgrade), using a compressed form, also cached,
+        // if the request accepts a supported content coding and the body is at least the specified threshold size (a negative threshold disables compression)
+        void set_cached_reply(const web::http::http_request& req, web::http::http_response& res, web::http::status_code code, const nmos::resource& resource, const std::shared_ptr<const utility::string_t>& serialized, int compression_threshold)
+        {
+            set_reply(res, code, *serialized, web::http::details::mime_types::application_json);
+
+            if (0 > compression_threshold || serialized->size() < (size_t)compression_threshold) return;
+            // the body of a HEAD response is discarded, and the HTML rendering requires the uncompressed body (see make_api_finally_handler)
+            if (web::http::has_header_value(req.headers(), nmos::details::actual_method, web::http::methods::HEAD)) return;
+            if (details::is_html_response_preferred(req, web::http::details::mime_types::application_json)) return;
+
+            const auto content_encoding = negotiate_content_encoding(req);
+            if (content_encoding.empty()) return;
+
+            const auto compressed = resource.serialized.get_compressed(serialized, content_encoding, [&content_encoding](const utility::string_t& body)
+            {
+                const auto utf8 = utility::conversions::to_utf8string(body);
+                return compress(content_encoding, (const uint8_t*)utf8.data(), utf8.size());
+            });
+            details::set_compressed_body(res, *compressed, content_encoding);
+        }
+
+        // set up a response with a JSON array body, assembled from the specified serialized elements as per nmos::set_reply_json_array, or using a compressed form,
+        // kept in the specified compressed bodies, if the request accepts a supported content coding and the body is at least the specified threshold size
+        // (a negative threshold disables compression)
+        void set_cached_reply_json_array(const web::http::http_request& req, web::http::http_response& res, web::http::status_code code, std::vector<std::shared_ptr<const utility::string_t>> elements, compressed_bodies& compressed, int compression_threshold)
+        {
+            size_t size = 2;
+            for (const auto& element : elements) size += element->size() + 1;
+
+            // the body of a HEAD response is discarded, and the HTML rendering requires the uncompressed body (see make_api_finally_handler)
+            const auto content_encoding = 0 > compression_threshold || size < (size_t)compression_threshold
+                || web::http::has_header_value(req.headers(), nmos::details::actual_method, web::http::methods::HEAD)
+                || details::is_html_response_preferred(req, web::http::details::mime_types::application_json)
+                ? utility::string_t{}
+                : negotiate_content_encoding(req);
+            if (content_encoding.empty())
+            {
+                set_reply_json_array(req, res, code, std::move(elements));
+                return;
+            }
+
+            const auto body = compressed.get(content_encoding, [&]
+            {
+                std::string utf8;
+                utf8.reserve(size);
+                utf8.push_back('[');
+                for (const auto& element : elements)
+                {
+                    if (&element != &elements.front()) utf8.push_back(',');
+                    utf8.append(utility::conversions::to_utf8string(*element));
+                }
+                utf8.push_back(']');
+                return compress(content_encoding, (const uint8_t*)utf8.data(), utf8.size());
+            });
+
+            set_reply(res, code);
+            res.headers().set_content_type(web::http::details::mime_types::application_json);
+            details::set_compressed_body(res, *body, content_encoding);
+        }
+    }
+
     // add handler to set appropriate response headers, and error response body if indicated - call this only after adding all others!
-    void add_api_finally_handler(web::http::experimental::listener::api_router& api, slog::base_gate& gate_)
+    void add_api_finally_handler(web::http::experimental::listener::api_router& api, slog::base_gate& gate)
+    {
+        add_api_finally_handler(api, -1, gate);
+    }
+
+    // add handler to set appropriate response headers, and error response body if indicated, and to compress response bodies of at least the specified threshold size,
+    // when the request permits (a negative threshold disables compression) - call this only after adding all others!
+    void add_api_finally_handler(web::http::experimental::listener::api_router& api, int compression_threshold, slog::base_gate& gate_)
     {
         using namespace web::http::experimental::listener::api_router_using_declarations;
 
-        api.support(U(".*"), details::make_api_finally_handler(gate_));
+        api.support(U(".*"), details::make_api_finally_handler(compression_threshold, gate_));
 
         api.set_exception_handler([&gate_](http_request req, http_response res, const string_t&, const route_parameters& parameters)
         {
@@ -630,7 +1053,14 @@ namespace nmos
     // modify the specified API to handle all requests (including CORS preflight requests via "OPTIONS") and attach it to the specified listener - captures api by reference!
     void support_api(web::http::experimental::listener::http_listener& listener, web::http::experimental::listener::api_router& api, slog::base_gate& gate)
     {
-        add_api_finally_handler(api, gate);
+        support_api(listener, api, -1, gate);
+    }
+
+    // modify the specified API to handle all requests (including CORS preflight requests via "OPTIONS"), compressing response bodies of at least the specified threshold size,
+    // and attach it to the specified listener - captures api by reference!
+    void support_api(web::http::experimental::listener::http_listener& listener, web::http::experimental::listener::api_router& api, int compression_threshold, slog::base_gate& gate)
+    {
+        add_api_finally_handler(api, compression_threshold, gate);
         listener.support(std::ref(api));
         listener.support(web::http::methods::OPTIONS, std::ref(api)); // to handle CORS preflight requests
         listener.support(web::http::methods::HEAD, [&api](web::http::http_request req) // to handle HEAD requests
@@ -645,9 +1075,16 @@ namespace nmos
     // construct an http_listener on the specified address and port, modifying the specified API to handle all requests
     // (including CORS preflight requests via "OPTIONS") - captures api by reference!
     web::http::experimental::listener::http_listener make_api_listener(bool secure, const utility::string_t& host_address, int port, web::http::experimental::listener::api_router& api, web::http::experimental::listener::http_listener_config config, slog::base_gate& gate)
+    {
+        return make_api_listener(secure, host_address, port, api, std::move(config), -1, gate);
+    }
+
+    // construct an http_listener on the specified address and port, modifying the specified API to handle all requests
+    // (including CORS preflight requests via "OPTIONS"), compressing response bodies of at least the specified threshold size - captures api by reference!
+    web::http::experimental::listener::http_listener make_api_listener(bool secure, const utility::string_t& host_address, int port, web::http::experimental::listener::api_router& api, web::http::experimental::listener::http_listener_config config, int compression_threshold, slog::base_gate& gate)
     {
         web::http::experimental::listener::http_listener api_listener(web::http::experimental::listener::make_listener_uri(secure, host_address, port), std::move(config));
-        nmos::support_api(api_listener, api, gate);
+        nmos::support_api(api_listener, api, compression_threshold, gate);
         return api_listener;
     }
 
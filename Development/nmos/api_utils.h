@@ -1,8 +1,12 @@
 #ifndef NMOS_API_UTILS_H
 #define NMOS_API_UTILS_H
 
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <vector>
 #include "cpprest/api_router.h"
 #include "cpprest/http_listener.h" // for web::http::experimental::listener::http_listener_config
 #include "cpprest/regex_utils.h"
@@ -18,6 +22,8 @@ namespace slog
 namespace nmos
 {
     struct api_version;
+    struct resource;
+    struct tai;
     struct type;
 
     // Patterns are used to form parameterised route paths
@@ -111,16 +117,94 @@ namespace nmos
     // set up a standard NMOS error response, using the default reason phrase and the specified debug information
     void set_error_reply(web::http::http_response& res, web::http::status_code code, const std::exception& debug);
 
+    // set up a response with a JSON array body, assembled from the specified serialized elements (e.g. see nmos::serialize_downgrade)
+    // large bodies are streamed, using chunked transfer encoding, each element being written in the continuation of the previous write,
+    // rather than being concatenated into one string, so that sending can begin straight away, and stops if the client goes away
+    // (writing waits while more than a high-water mark of the body is yet to be sent, so that the memory held for a slow client is bounded)
+    // (the elements are shared, so may be collected while holding the model mutex, which is not required while the response is sent)
+    void set_reply_json_array(const web::http::http_request& req, web::http::http_response& res, web::http::status_code code, std::vector<std::shared_ptr<const utility::string_t>> elements);
+
+    // experimental extensions, to support conditional requests, and to compress HTTP response bodies using "gzip" or "deflate" Content-Encoding,
+    // if supported by the C++ REST SDK
+    namespace experimental
+    {
+        // negotiate a supported content coding from the request's Accept-Encoding header, or return an empty string for "identity"
+        utility::string_t negotiate_content_encoding(const web::http::http_request& req);
+
+        // compress the specified data using the specified content coding
+        std::vector<uint8_t> compress(const utility::string_t& content_encoding, const uint8_t* data, size_t size);
+
+        // make a strong entity-tag for a resource, from its update timestamp (which is unique, since it is strictly increasing)
+        utility::string_t make_etag(const nmos::tai& updated);
+
+        // make a strong entity-tag for a page of resources, from the paging parameters that are returned in the X-Paging-Since and X-Paging-Until headers
+        // and the number of resources in the page, and optionally the generation of the resources (see nmos::resources), since expiry doesn't change the paging parameters
+        utility::string_t make_etag(const nmos::tai& since, const nmos::tai& until, size_t count, std::uint64_t generation = 0);
+
+        // determine whether the request's If-None-Match header matches the specified entity-tag, i.e. whether a 304 Not Modified response should be sent
+        // see https://tools.ietf.org/html/rfc7232#section-3.2
+        bool is_not_modified(const web::http::http_request& req, const utility::string_t& etag);
+
+        // set up a response with a serialized JSON body from the resource's cache (see nmos::serialize_downgrade), using a compressed form, also cached,
+        // if the request accepts a supported content coding and the body is at least the specified threshold size (a negative threshold disables compression)
+        void set_cached_reply(const web::http::http_request& req, web::http::http_response& res, web::http::status_code code, const nmos::resource& resource, const std::shared_ptr<const utility::string_t>& serialized, int compression_threshold);
+
+        // the compressed forms of a response body, for each content coding, which are built on demand and kept along with the body itself, e.g. in a cache
+        class compressed_bodies
+        {
+        public:
+            typedef std::shared_ptr<const std::vector<uint8_t>> compressed_type;
+
+            // get the compressed form with the specified content coding, or build it using the specified function and keep it
+            // concurrent readers may build the same compressed form, but only one will be kept
+            template <typename Compress>
+            compressed_type get(const utility::string_t& content_encoding, Compress compress)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    auto found = compressed.find(content_encoding);
+                    if (compressed.end() != found) return found->second;
+                }
+
+                compressed_type result = std::make_shared<const std::vector<uint8_t>>(compress());
+
+                std::lock_guard<std::mutex> lock(mutex);
+                return compressed.insert({ content_encoding, result }).first->second;
+            }
+
+        private:
+            std::mutex mutex;
+            std::map<utility::string_t, compressed_type> compressed;
+        };
+
+        // set up a response with a JSON array body, assembled from the specified serialized elements as per nmos::set_reply_json_array, or using a compressed form,
+        // kept in the specified compressed bodies, if the request accepts a supported content coding and the body is at least the specified threshold size
+        // (a negative threshold disables compression)
+        void set_cached_reply_json_array(const web::http::http_request& req, web::http::http_response& res, web::http::status_code code, std::vector<std::shared_ptr<const utility::string_t>> elements, compressed_bodies& compressed, int compression_threshold);
+    }
+
     // add handler to set appropriate response headers, and error response body if indicated - call this only after adding all others!
     void add_api_finally_handler(web::http::experimental::listener::api_router& api, slog::base_gate& gate);
 
+    // add handler to set appropriate response headers, and error response body if indicated, and to compress response bodies of at least the specified threshold size,
+    // when the request permits (a negative threshold disables compression) - call this only after adding all others!
+    void add_api_finally_handler(web::http::experimental::listener::api_router& api, int compression_threshold, slog::base_gate& gate);
+
     // modify the specified API to handle all requests (including CORS preflight requests via "OPTIONS") and attach it to the specified listener - captures api by reference!
     void support_api(web::http::experimental::listener::http_listener& listener, web::http::experimental::listener::api_router& api, slog::base_gate& gate);
 
+    // modify the specified API to handle all requests (including CORS preflight requests via "OPTIONS"), compressing response bodies of at least the specified threshold size,
+    // and attach it to the specified listener - captures api by reference!
+    void support_api(web::http::experimental::listener::http_listener& listener, web::http::experimental::listener::api_router& api, int compression_threshold, slog::base_gate& gate);
+
     // construct an http_listener on the specified address and port, modifying the specified API to handle all requests
     // (including CORS preflight requests via "OPTIONS") - captures api by reference!
     web::http::experimental::listener::http_listener make_api_listener(bool secure, const utility::string_t& host_address, int port, web::http::experimental::listener::api_router& api, web::http::experimental::listener::http_listener_config config, slog::base_gate& gate);
 
+    // construct an http_listener on the specified address and port, modifying the specified API to handle all requests
+    // (including CORS preflight requests via "OPTIONS"), compressing response bodies of at least the specified threshold size - captures api by reference!
+    web::http::experimental::listener::http_listener make_api_listener(bool secure, const utility::string_t& host_address, int port, web::http::experimental::listener::api_router& api, web::http::experimental::listener::http_listener_config config, int compression_threshold, slog::base_gate& gate);
+
     // construct an http_listener on the specified port, modifying the specified API to handle all requests
     // (including CORS preflight requests via "OPTIONS") - captures api by reference!
     inline web::http::experimental::listener::http_listener make_api_listener(int port, web::http::experimental::listener::api_router& api, web::http::experimental::listener::http_listener_config config, slog::base_gate& gate)
@@ -172,6 +256,9 @@ namespace nmos
 
         // make handler to set appropriate response headers, and error response body if indicated
         web::http::experimental::listener::route_handler make_api_finally_handler(slog::base_gate& gate);
+
+        // make handler to set appropriate response headers, and error response body if indicated, and to compress response bodies of at least the specified threshold size
+        web::http::experimental::listener::route_handler make_api_finally_handler(int compression_threshold, slog::base_gate& gate);
     }
 }
 
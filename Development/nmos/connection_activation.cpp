@@ -1,23 +1,267 @@
 #include "nmos/connection_activation.h"
 
-#include "detail/for_each_reversed.h"
+#include <atomic>
+#include <map>
+#include <queue>
 #include "nmos/activation_mode.h"
 #include "nmos/connection_api.h" // for nmos::set_connection_resource_active, etc.
 #include "nmos/model.h"
 #include "nmos/slog.h"
 #include "nmos/thread_utils.h"
+#include "pplx/pplxtasks.h"
 
 namespace nmos
 {
+    namespace details
+    {
+        // the staged activation of a connection resource, which identifies whether an activation has been cancelled or replaced,
+        // since other changes to the resource, e.g. to the staged transport parameters, don't affect it (cf. nmos::details::is_activation_modified)
+        inline const web::json::value& get_staged_activation(const nmos::resource& connection_resource)
+        {
+            return nmos::fields::activation(nmos::fields::endpoint_staged(connection_resource.data));
+        }
+
+        // a scheduled activation is only still valid if the staged activation has not been changed (i.e. the activation cancelled or rescheduled) since
+        // and it is the most recently queued for the resource (see latest_scheduled_activations)
+        struct scheduled_activation
+        {
+            nmos::tai_clock::time_point time;
+            std::pair<nmos::id, nmos::type> id_type;
+            web::json::value staged_activation;
+            std::uint64_t sequence;
+
+            friend bool operator>(const scheduled_activation& lhs, const scheduled_activation& rhs) { return lhs.time > rhs.time; }
+        };
+
+        typedef std::priority_queue<scheduled_activation, std::vector<scheduled_activation>, std::greater<scheduled_activation>> scheduled_activations;
+
+        // the sequence number and staged activation of the most recently queued scheduled activation of each resource, so that an activation is only queued once
+        // however many times the resource is updated before it is due, and any earlier entries in the queue for the resource are skipped
+        typedef std::map<std::pair<nmos::id, nmos::type>, std::pair<std::uint64_t, web::json::value>> latest_scheduled_activations;
+
+        // pop the scheduled activation from the top of the queue, and return whether it is still valid
+        bool pop_scheduled_activation(scheduled_activations& queue, latest_scheduled_activations& latest, const nmos::resources& connection_resources)
+        {
+            const auto scheduled_activation = queue.top();
+            queue.pop();
+
+            auto found = latest.find(scheduled_activation.id_type);
+            if (latest.end() == found || scheduled_activation.sequence != found->second.first) return false;
+            latest.erase(found);
+
+            auto resource = find_resource(connection_resources, scheduled_activation.id_type);
+            return connection_resources.end() != resource && get_staged_activation(*resource) == scheduled_activation.staged_activation;
+        }
+
+        // whether the scheduled activation at the top of the queue is still valid, without popping it
+        bool is_valid_scheduled_activation(const scheduled_activations& queue, const latest_scheduled_activations& latest, const nmos::resources& connection_resources)
+        {
+            const auto& scheduled_activation = queue.top();
+
+            auto found = latest.find(scheduled_activation.id_type);
+            if (latest.end() == found || scheduled_activation.sequence != found->second.first) return false;
+
+            auto resource = find_resource(connection_resources, scheduled_activation.id_type);
+            return connection_resources.end() != resource && get_staged_activation(*resource) == scheduled_activation.staged_activation;
+        }
+
+        // log the current exception during activation of the specified resource
+        void log_connection_activation_exception(const std::pair<nmos::id, nmos::type>& id_type, slog::base_gate& gate)
+        {
+            // try-catch based on the exception handler in nmos::add_api_finally_handler
+            try
+            {
+                throw;
+            }
+            catch (const web::json::json_exception& e)
+            {
+                slog::log<slog::severities::error>(gate, SLOG_FLF) << "JSON error for " << id_type << " during activation: " << e.what();
+            }
+            catch (const std::runtime_error& e)
+            {
+                slog::log<slog::severities::error>(gate, SLOG_FLF) << "Implementation error for " << id_type << " during activation: " << e.what();
+            }
+            catch (const std::logic_error& e)
+            {
+                slog::log<slog::severities::error>(gate, SLOG_FLF) << "Implementation error for " << id_type << " during activation: " << e.what();
+            }
+            catch (const std::exception& e)
+            {
+                slog::log<slog::severities::error>(gate, SLOG_FLF) << "Unexpected exception for " << id_type << " during activation: " << e.what();
+            }
+            catch (...)
+            {
+                slog::log<slog::severities::severe>(gate, SLOG_FLF) << "Unexpected unknown exception for " << id_type << " during activation";
+            }
+        }
+
+        // an activation whose callbacks are run on copies of the resources, without the model locked
+        struct concurrent_activation
+        {
+            std::pair<nmos::id, nmos::type> id_type;
+            // the staged activation when the connection resource was copied, to identify whether it has since been cancelled or replaced
+            web::json::value staged_activation;
+            nmos::resource resource;
+            nmos::resource connection_resource;
+            nmos::tai activation_time;
+
+            bool activated;
+            bool active;
+            nmos::id connected_id;
+        };
+
+        // process the specified activations, running the callbacks for up to the specified number of resources concurrently, with the model unlocked
+        // then committing the results back to the model
+        void process_activations_concurrently(nmos::node_model& model, nmos::write_lock& lock, const std::vector<std::pair<nmos::id, nmos::type>>& due_activations, std::size_t concurrency, connection_resource_auto_resolver resolve_auto, connection_sender_transportfile_setter set_transportfile, connection_activation_handler connection_activated, slog::base_gate& gate)
+        {
+            // lock.owns_lock() must be true initially
+            std::vector<concurrent_activation> activations;
+            activations.reserve(due_activations.size());
+
+            for (const auto& id_type : due_activations)
+            {
+                auto found = find_resource(model.connection_resources, id_type);
+                if (model.connection_resources.end() == found) continue;
+
+                auto matching_resource = find_resource(model.node_resources, id_type);
+                if (model.node_resources.end() == matching_resource)
+                {
+                    try
+                    {
+                        throw std::logic_error("matching IS-04 resource not found");
+                    }
+                    catch (...)
+                    {
+                        log_connection_activation_exception(id_type, gate);
+                    }
+
+                    nmos::modify_resource(model.connection_resources, id_type.first, [&](nmos::resource& connection_resource)
+                    {
+                        nmos::set_connection_resource_not_pending(connection_resource);
+                    });
+                    continue;
+                }
+
+                activations.push_back({ id_type, get_staged_activation(*found), *matching_resource, *found, nmos::tai_now(), false, false, {} });
+            }
+
+            {
+                // the callbacks run on the copies, so the model can be unlocked while they do
+                details::reverse_lock_guard<nmos::write_lock> unlock{ lock };
+
+                std::atomic<std::size_t> next{ 0 };
+                const auto activate = [&]
+                {
+                    for (auto i = next++; i < activations.size(); i = next++)
+                    {
+                        auto& activation = activations[i];
+                        auto& connection_resource = activation.connection_resource;
+
+                        try
+                        {
+                            nmos::set_connection_resource_active(connection_resource, [&](web::json::value& endpoint_active)
+                            {
+                                // see nmos::connection_activation_thread
+                                resolve_auto(activation.resource, connection_resource, nmos::fields::transport_params(endpoint_active));
+
+                                activation.active = nmos::fields::master_enable(endpoint_active);
+                                auto& connected_id_or_null = nmos::types::sender == activation.id_type.second ? nmos::fields::receiver_id(endpoint_active) : nmos::fields::sender_id(endpoint_active);
+                                if (!connected_id_or_null.is_null()) activation.connected_id = connected_id_or_null.as_string();
+                            }, activation.activation_time);
+
+                            if (nmos::types::sender == activation.id_type.second)
+                            {
+                                set_transportfile(activation.resource, connection_resource, connection_resource.data[nmos::fields::endpoint_transportfile]);
+                            }
+
+                            nmos::set_resource_subscription(activation.resource, activation.active, activation.connected_id, activation.activation_time);
+
+                            activation.activated = true;
+
+                            if (connection_activated)
+                            {
+                                connection_activated(activation.resource, connection_resource);
+                            }
+                        }
+                        catch (...)
+                        {
+                            log_connection_activation_exception(activation.id_type, gate);
+                        }
+                    }
+                };
+
+                // the additional workers run on the pplx scheduler's thread pool, rather than threads being created for each batch of activations
+                std::vector<pplx::task<void>> workers;
+                for (std::size_t worker = 1; worker < (std::min)(concurrency, activations.size()); ++worker)
+                {
+                    workers.push_back(pplx::create_task(activate));
+                }
+                activate();
+                pplx::when_all(workers.begin(), workers.end()).wait();
+            }
+
+            // commit the results back to the model
+            // only the fields changed by the activation are committed, since the resources may have been modified in other ways while the model was unlocked
+
+            for (const auto& activation : activations)
+            {
+                auto found = find_resource(model.connection_resources, activation.id_type);
+                if (model.connection_resources.end() == found) continue;
+
+                // a scheduled activation may have been cancelled or replaced while the model was unlocked, in which case the staged endpoint is left alone
+                const bool pending = get_staged_activation(*found) == activation.staged_activation;
+
+                if (!activation.activated)
+                {
+                    if (pending)
+                    {
+                        nmos::modify_resource(model.connection_resources, activation.id_type.first, [&](nmos::resource& connection_resource)
+                        {
+                            nmos::set_connection_resource_not_pending(connection_resource);
+                        });
+                    }
+                    continue;
+                }
+
+                nmos::modify_resource(model.connection_resources, activation.id_type.first, [&](nmos::resource& connection_resource)
+                {
+                    const auto& activated = activation.connection_resource.data;
+
+                    connection_resource.data[nmos::fields::version] = activated.at(nmos::fields::version);
+                    connection_resource.data[nmos::fields::endpoint_active] = activated.at(nmos::fields::endpoint_active);
+                    if (nmos::types::sender == activation.id_type.second)
+                    {
+                        connection_resource.data[nmos::fields::endpoint_transportfile] = activated.at(nmos::fields::endpoint_transportfile);
+                    }
+                    if (pending)
+                    {
+                        connection_resource.data[nmos::fields::endpoint_staged][nmos::fields::activation] = nmos::fields::activation(nmos::fields::endpoint_staged(activated));
+                    }
+                });
+
+                nmos::modify_resource(model.node_resources, activation.id_type.first, [&activation](nmos::resource& resource)
+                {
+                    nmos::set_resource_subscription(resource, activation.active, activation.connected_id, activation.activation_time);
+                });
+            }
+        }
+    }
+
     void connection_activation_thread(nmos::node_model& model, connection_resource_auto_resolver resolve_auto, connection_sender_transportfile_setter set_transportfile, connection_activation_handler connection_activated, slog::base_gate& gate)
     {
         auto lock = model.write_lock(); // in order to update the resources
 
         auto most_recent_update = nmos::tai_min();
-        auto earliest_scheduled_activation = (nmos::tai_clock::time_point::max)();
+
+        // pending scheduled activations, earliest first
+        details::scheduled_activations scheduled_activations;
+        details::latest_scheduled_activations latest_scheduled_activations;
+        std::uint64_t scheduled_activations_sequence = 0;
 
         for (;;)
         {
+            const auto earliest_scheduled_activation = !scheduled_activations.empty() ? scheduled_activations.top().time : (nmos::tai_clock::time_point::max)();
+
             // wait for the thread to be interrupted because there may be new scheduled activations, or immediate activations to process
             // or because the server is being shut down
             // or because it's time for the next scheduled activation
@@ -26,21 +270,19 @@ namespace nmos
 
             auto& by_updated = model.connection_resources.get<nmos::tags::updated>();
 
-            // go through all connection resources
-            // process any immediate activations
-            // process any scheduled activations whose requested_time has passed
-            // identify the next scheduled activation
+            // go through only the connection resources updated since the previous pass, since staging any activation updates the resource
+            // queue any immediate activations
+            // add any scheduled activations to the pending scheduled activations
+            // then dequeue the pending scheduled activations whose requested_time has passed
 
             const auto now = nmos::tai_clock::now();
 
-            earliest_scheduled_activation = (nmos::tai_clock::time_point::max)();
+            std::vector<std::pair<nmos::id, nmos::type>> due_activations;
 
-            bool notify = false;
-
-            // since modify reorders the resource in this index, use for_each_reversed
-            detail::for_each_reversed(by_updated.begin(), by_updated.end(), [&](const nmos::resource& resource)
+            for (auto updated = by_updated.begin(); by_updated.end() != updated && most_recent_update < updated->updated; ++updated)
             {
-                if (!resource.has_data()) return;
+                const nmos::resource& resource = *updated;
+                if (!resource.has_data()) continue;
 
                 const std::pair<nmos::id, nmos::type> id_type{ resource.id, resource.type };
 
@@ -48,153 +290,166 @@ namespace nmos
                 auto& staged_activation = nmos::fields::activation(staged);
                 auto& staged_mode_or_null = nmos::fields::mode(staged_activation);
 
-                if (staged_mode_or_null.is_null()) return;
+                if (staged_mode_or_null.is_null()) continue;
 
                 const nmos::activation_mode staged_mode{ staged_mode_or_null.as_string() };
 
                 if (nmos::activation_modes::activate_scheduled_absolute == staged_mode ||
                     nmos::activation_modes::activate_scheduled_relative == staged_mode)
                 {
+                    // other updates to the resource, e.g. to the staged transport parameters, don't affect an activation which is already queued
+                    auto& latest = latest_scheduled_activations[id_type];
+                    if (0 != latest.first && latest.second == staged_activation) continue;
+
                     auto& staged_activation_time = nmos::fields::activation_time(staged_activation);
                     const auto scheduled_activation = nmos::time_point_from_tai(nmos::parse_version(staged_activation_time.as_string()));
 
-                    if (scheduled_activation < now)
-                    {
-                        slog::log<slog::severities::info>(gate, SLOG_FLF) << "Processing scheduled activation for " << id_type;
-                    }
-                    else
-                    {
-                        if (scheduled_activation < earliest_scheduled_activation)
-                        {
-                            earliest_scheduled_activation = scheduled_activation;
-                        }
-
-                        return;
-                    }
+                    latest = { ++scheduled_activations_sequence, staged_activation };
+                    scheduled_activations.push({ scheduled_activation, id_type, staged_activation, latest.first });
                 }
                 else if (nmos::activation_modes::activate_immediate == staged_mode)
                 {
                     // check for cancelled in-flight immediate activation
-                    if (nmos::fields::requested_time(staged_activation).is_null()) return;
+                    if (nmos::fields::requested_time(staged_activation).is_null()) continue;
                     // check for processed in-flight immediate activation
-                    if (!nmos::fields::activation_time(staged_activation).is_null()) return;
+                    if (!nmos::fields::activation_time(staged_activation).is_null()) continue;
 
                     slog::log<slog::severities::info>(gate, SLOG_FLF) << "Processing immediate activation for " << id_type;
+
+                    due_activations.push_back(id_type);
                 }
                 else
                 {
                     slog::log<slog::severities::severe>(gate, SLOG_FLF) << "Unexpected activation mode for " << id_type;
-                    return;
                 }
+            }
 
-                const auto activation_time = nmos::tai_now();
+            while (!scheduled_activations.empty() && scheduled_activations.top().time < now)
+            {
+                const auto id_type = scheduled_activations.top().id_type;
 
-                bool active = false;
-                nmos::id connected_id;
+                // skip any scheduled activation which has since been cancelled, rescheduled or superseded
+                if (!details::pop_scheduled_activation(scheduled_activations, latest_scheduled_activations, model.connection_resources)) continue;
 
-                // Update the IS-05 and IS-04 resources
+                slog::log<slog::severities::info>(gate, SLOG_FLF) << "Processing scheduled activation for " << id_type;
 
-                // ensure nmos::set_connection_resource_not_pending is called to 'unlock' the resource for the Connection API implementation
-                // after an exception; for immediate activations this will cause a 500 Internal Error status code to be returned
-                const auto handle_connection_activation_exception = [&](const std::pair<nmos::id, nmos::type>& id_type)
-                {
-                    // try-catch based on the exception handler in nmos::add_api_finally_handler
-                    try
-                    {
-                        throw;
-                    }
-                    catch (const web::json::json_exception& e)
-                    {
-                        slog::log<slog::severities::error>(gate, SLOG_FLF) << "JSON error for " << id_type << " during activation: " << e.what();
-                    }
-                    catch (const std::runtime_error& e)
-                    {
-                        slog::log<slog::severities::error>(gate, SLOG_FLF) << "Implementation error for " << id_type << " during activation: " << e.what();
-                    }
-                    catch (const std::logic_error& e)
-                    {
-                        slog::log<slog::severities::error>(gate, SLOG_FLF) << "Implementation error for " << id_type << " during activation: " << e.what();
-                    }
-                    catch (const std::exception& e)
-                    {
-                        slog::log<slog::severities::error>(gate, SLOG_FLF) << "Unexpected exception for " << id_type << " during activation: " << e.what();
-                    }
-                    catch (...)
-                    {
-                        slog::log<slog::severities::severe>(gate, SLOG_FLF) << "Unexpected unknown exception for " << id_type << " during activation";
-                    }
+                due_activations.push_back(id_type);
+            }
 
-                    nmos::modify_resource(model.connection_resources, id_type.first, [&](nmos::resource& connection_resource)
-                    {
-                        nmos::set_connection_resource_not_pending(connection_resource);
-                    });
-                };
+            bool notify = false;
+
+            // when the callbacks are run with the model unlocked, other updates may be made meanwhile, which must not be missed on the next pass
+            const auto scanned_until = nmos::most_recent_update(model.connection_resources);
 
-                try
+            const auto concurrency = (std::size_t)(std::max)(1, nmos::experimental::fields::connection_activation_concurrency(model.settings));
+            const bool concurrent = 1 < concurrency && 1 < due_activations.size();
+
+            if (concurrent)
+            {
+                details::process_activations_concurrently(model, lock, due_activations, concurrency, resolve_auto, set_transportfile, connection_activated, gate);
+                notify = true;
+            }
+            else
+            {
+                for (const auto& id_type : due_activations)
                 {
-                    auto matching_resource = find_resource(model.node_resources, id_type);
-                    if (model.node_resources.end() == matching_resource)
+                    auto found = find_resource(model.connection_resources, id_type);
+                    if (model.connection_resources.end() == found) continue;
+                    const nmos::resource& resource = *found;
+
+                    const auto activation_time = nmos::tai_now();
+
+                    bool active = false;
+                    nmos::id connected_id;
+
+                    // Update the IS-05 and IS-04 resources
+
+                    // ensure nmos::set_connection_resource_not_pending is called to 'unlock' the resource for the Connection API implementation
+                    // after an exception; for immediate activations this will cause a 500 Internal Error status code to be returned
+                    const auto handle_connection_activation_exception = [&](const std::pair<nmos::id, nmos::type>& id_type)
                     {
-                        throw std::logic_error("matching IS-04 resource not found");
-                    }
+                        details::log_connection_activation_exception(id_type, gate);
 
-                    nmos::modify_resource(model.connection_resources, id_type.first, [&](nmos::resource& connection_resource)
+                        nmos::modify_resource(model.connection_resources, id_type.first, [&](nmos::resource& connection_resource)
+                        {
+                            nmos::set_connection_resource_not_pending(connection_resource);
+                        });
+                    };
+
+                    try
                     {
-                        // Update the IS-05 resource's /active endpoint
+                        auto matching_resource = find_resource(model.node_resources, id_type);
+                        if (model.node_resources.end() == matching_resource)
+                        {
+                            throw std::logic_error("matching IS-04 resource not found");
+                        }
 
-                        nmos::set_connection_resource_active(connection_resource, [&](web::json::value& endpoint_active)
+                        nmos::modify_resource(model.connection_resources, id_type.first, [&](nmos::resource& connection_resource)
                         {
-                            // the resolve_auto callback may throw exceptions, which will prevent activation in order that
-                            // "if there is an error condition that means `auto` cannot be resolved, the active transport parameters
-                            // must not change, and the underlying sender [or receiver] must continue as before."
-                            // see https://github.com/AMWA-TV/nmos-device-connection-management/blob/v1.1-dev/APIs/ConnectionAPI.raml#L308-L309
-                            resolve_auto(*matching_resource, connection_resource, nmos::fields::transport_params(endpoint_active));
+                            // Update the IS-05 resource's /active endpoint
 
-                            active = nmos::fields::master_enable(endpoint_active);
-                            // Senders indicate the connected receiver_id, receivers indicate the connected sender_id
-                            auto& connected_id_or_null = nmos::types::sender == id_type.second ? nmos::fields::receiver_id(endpoint_active) : nmos::fields::sender_id(endpoint_active);
-                            if (!connected_id_or_null.is_null()) connected_id = connected_id_or_null.as_string();
-                        }, activation_time);
+                            nmos::set_connection_resource_active(connection_resource, [&](web::json::value& endpoint_active)
+                            {
+                                // the resolve_auto callback may throw exceptions, which will prevent activation in order that
+                                // "if there is an error condition that means `auto` cannot be resolved, the active transport parameters
+                                // must not change, and the underlying sender [or receiver] must continue as before."
+                                // see https://github.com/AMWA-TV/nmos-device-connection-management/blob/v1.1-dev/APIs/ConnectionAPI.raml#L308-L309
+                                resolve_auto(*matching_resource, connection_resource, nmos::fields::transport_params(endpoint_active));
 
-                        // Update an IS-05 sender's /transportfile endpoint
+                                active = nmos::fields::master_enable(endpoint_active);
+                                // Senders indicate the connected receiver_id, receivers indicate the connected sender_id
+                                auto& connected_id_or_null = nmos::types::sender == id_type.second ? nmos::fields::receiver_id(endpoint_active) : nmos::fields::sender_id(endpoint_active);
+                                if (!connected_id_or_null.is_null()) connected_id = connected_id_or_null.as_string();
+                            }, activation_time);
 
-                        if (nmos::types::sender == id_type.second)
-                        {
-                            // hm, the matching IS-04 resource's subscription will not have been updated yet, but that probably doesn't matter to this callback?
+                            // Update an IS-05 sender's /transportfile endpoint
 
-                            // this callback should not throw exceptions, as the active transport parameters will already have been changed and those changes will not be rolled back
-                            set_transportfile(*matching_resource, connection_resource, connection_resource.data[nmos::fields::endpoint_transportfile]);
-                        }
-                    });
+                            if (nmos::types::sender == id_type.second)
+                            {
+                                // hm, the matching IS-04 resource's subscription will not have been updated yet, but that probably doesn't matter to this callback?
 
-                    // Update the IS-04 resource's subscription
+                                // this callback should not throw exceptions, as the active transport parameters will already have been changed and those changes will not be rolled back
+                                set_transportfile(*matching_resource, connection_resource, connection_resource.data[nmos::fields::endpoint_transportfile]);
+                            }
+                        });
 
-                    nmos::modify_resource(model.node_resources, id_type.first, [&activation_time, &active, &connected_id](nmos::resource& resource)
-                    {
-                        nmos::set_resource_subscription(resource, active, connected_id, activation_time);
-                    });
+                        // Update the IS-04 resource's subscription
+
+                        nmos::modify_resource(model.node_resources, id_type.first, [&activation_time, &active, &connected_id](nmos::resource& resource)
+                        {
+                            nmos::set_resource_subscription(resource, active, connected_id, activation_time);
+                        });
 
-                    // Synchronous notification that the active parameters for the specified (IS-04/IS-05) sender/connection_sender or receiver/connection_receiver have changed
-                    // and the underlying implementation should make or break this connection according to the values in the /active endpoint
+                        // Synchronous notification that the active parameters for the specified (IS-04/IS-05) sender/connection_sender or receiver/connection_receiver have changed
+                        // and the underlying implementation should make or break this connection according to the values in the /active endpoint
 
-                    if (connection_activated)
+                        if (connection_activated)
+                        {
+                            // this callback should not throw exceptions, as the active transport parameters will already have been changed and those changes will not be rolled back
+                            connection_activated(*matching_resource, resource);
+                        }
+                    }
+                    catch (...)
                     {
-                        // this callback should not throw exceptions, as the active transport parameters will already have been changed and those changes will not be rolled back
-                        connection_activated(*matching_resource, resource);
+                        handle_connection_activation_exception(id_type);
                     }
+
+                    notify = true;
                 }
-                catch (...)
-                {
-                    handle_connection_activation_exception(id_type);
-                }
+            }
 
-                notify = true;
-            });
+            // discard any cancelled or rescheduled activations from the top of the queue, so as not to wake up unnecessarily
+            while (!scheduled_activations.empty())
+            {
+                if (details::is_valid_scheduled_activation(scheduled_activations, latest_scheduled_activations, model.connection_resources)) break;
+                details::pop_scheduled_activation(scheduled_activations, latest_scheduled_activations, model.connection_resources);
+            }
 
-            if ((nmos::tai_clock::time_point::max)() != earliest_scheduled_activation)
+            if (!scheduled_activations.empty())
             {
-                slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Next scheduled activation is at " << nmos::make_version(nmos::tai_from_time_point(earliest_scheduled_activation))
-                    << " in about " << std::fixed << std::setprecision(3) << std::chrono::duration_cast<std::chrono::duration<double>>(earliest_scheduled_activation - now).count() << " seconds time";
+                const auto next_scheduled_activation = scheduled_activations.top().time;
+                slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Next scheduled activation is at " << nmos::make_version(nmos::tai_from_time_point(next_scheduled_activation))
+                    << " in about " << std::fixed << std::setprecision(3) << std::chrono::duration_cast<std::chrono::duration<double>>(next_scheduled_activation - now).count() << " seconds time";
             }
 
             if (notify)
@@ -203,7 +458,7 @@ namespace nmos
                 model.notify();
             }
 
-            most_recent_update = nmos::most_recent_update(model.connection_resources);
+            most_recent_update = concurrent ? scanned_until : nmos::most_recent_update(model.connection_resources);
         }
     }
 }
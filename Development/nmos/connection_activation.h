@@ -34,6 +34,8 @@ namespace nmos
     typedef std::function<void(const nmos::resource& resource, const nmos::resource& connection_resource)> connection_activation_handler;
 
     // callbacks from this function are called with the model locked, and may read but should not write directly to the model
+    // unless the connection_activation_concurrency setting is greater than 1, in which case, when several activations are due at once,
+    // the callbacks for different resources may be called concurrently, with copies of the resources and the model unlocked
     void connection_activation_thread(nmos::node_model& model, connection_resource_auto_resolver resolve_auto, connection_sender_transportfile_setter set_transportfile, connection_activation_handler connection_activated, slog::base_gate& gate);
 }
 
@@ -465,6 +465,17 @@ namespace nmos
             });
         }
 
+        // determine whether the staged activation of the specified resource has changed
+        // or the resource has vanished (unexpected!)
+        bool is_activation_modified(const nmos::node_model& model, const std::pair<nmos::id, nmos::type>& id_type, const web::json::value& initial_activation)
+        {
+            auto resource = find_resource(model.connection_resources, id_type);
+            if (model.connection_resources.end() == resource) return true;
+
+            auto& activation = nmos::fields::activation(nmos::fields::endpoint_staged(resource->data));
+            return activation != initial_activation;
+        }
+
         // wait for the staged activation of the specified resource to have changed
         // or for the resource to have vanished (unexpected!)
         // or for the server to be shut down
@@ -474,26 +485,31 @@ namespace nmos
         {
             return model.wait_for(lock, std::chrono::seconds(nmos::fields::immediate_activation_max(model.settings)), [&]
             {
-                if (model.shutdown) return true;
-
-                auto resource = find_resource(model.connection_resources, id_type);
-                if (model.connection_resources.end() == resource) return true;
+                return model.shutdown || is_activation_modified(model, id_type, initial_activation);
+            });
+        }
 
-                auto& activation = nmos::fields::activation(nmos::fields::endpoint_staged(resource->data));
-                return activation != initial_activation;
+        // wait for the staged activations of all the specified resources to have changed, or the resources to have vanished
+        // or for the server to be shut down
+        // or for the timeout to expire
+        template <class ReadOrWriteLock>
+        bool wait_activations_modified(nmos::node_model& model, ReadOrWriteLock& lock, const std::vector<std::pair<std::pair<nmos::id, nmos::type>, web::json::value>>& initial_activations)
+        {
+            return model.wait_for(lock, std::chrono::seconds(nmos::fields::immediate_activation_max(model.settings)), [&]
+            {
+                return model.shutdown || initial_activations.end() == std::find_if(initial_activations.begin(), initial_activations.end(), [&](const std::pair<std::pair<nmos::id, nmos::type>, web::json::value>& initial_activation)
+                {
+                    return !is_activation_modified(model, initial_activation.first, initial_activation.second);
+                });
             });
         }
 
-        void handle_immediate_activation_pending(nmos::node_model& model, nmos::write_lock& lock, const std::pair<nmos::id, nmos::type>& id_type, web::json::value& response_activation, slog::base_gate& gate)
+        // complete an in-flight immediate activation which has been processed, setting the activation in the response
+        // (the caller must notify the model once all such activations are complete)
+        void complete_immediate_activation(nmos::node_model& model, const std::pair<nmos::id, nmos::type>& id_type, web::json::value& response_activation)
         {
             using web::json::value;
 
-            // lock.owns_lock() must be true initially; waiting releases and reacquires the lock
-            if (!wait_activation_modified(model, lock, id_type, response_activation) || model.shutdown)
-            {
-                throw std::logic_error("timed out waiting for in-flight immediate activation to complete");
-            }
-
             auto& resources = model.connection_resources;
 
             // after releasing and reacquiring the lock, must find the resource again!
@@ -535,6 +551,17 @@ namespace nmos
                 response_activation[nmos::fields::activation_time] = staged_activation[nmos::fields::activation_time];
                 staged_activation[nmos::fields::activation_time] = value::null();
             });
+        }
+
+        void handle_immediate_activation_pending(nmos::node_model& model, nmos::write_lock& lock, const std::pair<nmos::id, nmos::type>& id_type, web::json::value& response_activation, slog::base_gate& gate)
+        {
+            // lock.owns_lock() must be true initially; waiting releases and reacquires the lock
+            if (!wait_activation_modified(model, lock, id_type, response_activation) || model.shutdown)
+            {
+                throw std::logic_error("timed out waiting for in-flight immediate activation to complete");
+            }
+
+            complete_immediate_activation(model, id_type, response_activation);
 
             // this is especially important to unblock other patch requests in details::wait_immediate_activation_not_pending
             slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying connection API - immediate activation completed";
@@ -1118,6 +1145,26 @@ namespace nmos
 
                 if (0 != patches.size()) details::notify_connection_resource_patch(model, gate);
 
+                // only pending immediate activations need to be processed before sending the response
+                // all of these have been staged as a batch, which the activation thread processes in a single pass, so wait just once for the whole batch
+                std::vector<std::pair<std::pair<nmos::id, nmos::type>, web::json::value>> immediate_activations;
+                {
+                    auto rit = results.begin();
+                    for (auto pit = patches.begin(); patches.end() != pit; ++pit, ++rit)
+                    {
+                        if (!web::http::is_success_status_code(rit->first)) continue;
+                        const auto& response_activation = rit->second.at(nmos::fields::activation);
+                        if (details::immediate_activation_pending != details::get_activation_state(response_activation)) continue;
+                        immediate_activations.push_back({ { nmos::fields::id(*pit), type }, response_activation });
+                    }
+                }
+
+                if (!immediate_activations.empty())
+                {
+                    // lock.owns_lock() must be true initially; waiting releases and reacquires the lock
+                    details::wait_activations_modified(model, lock, immediate_activations);
+                }
+
                 auto rit = results.begin();
                 for (auto pit = patches.begin(); patches.end() != pit; ++pit, ++rit)
                 {
@@ -1130,12 +1177,16 @@ namespace nmos
                     {
                         auto& response_activation = result.second[nmos::fields::activation];
 
-                        // only pending immediate activations need to be processed before sending the response
                         if (details::immediate_activation_pending == details::get_activation_state(response_activation))
                         {
                             try
                             {
-                                details::handle_immediate_activation_pending(model, lock, { id, type }, response_activation, gate);
+                                if (model.shutdown || !details::is_activation_modified(model, { id, type }, response_activation))
+                                {
+                                    throw std::logic_error("timed out waiting for in-flight immediate activation to complete");
+                                }
+
+                                details::complete_immediate_activation(model, { id, type }, response_activation);
                             }
                             catch (...)
                             {
@@ -1166,6 +1217,13 @@ namespace nmos
                     }
                 }
 
+                if (!immediate_activations.empty())
+                {
+                    // this is especially important to unblock other patch requests in details::wait_immediate_activation_not_pending
+                    slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying connection API - immediate activations completed";
+                    model.notify();
+                }
+
                 set_reply(res, status_codes::OK,
                     web::json::serialize(results,
                         [](const details::connection_resource_patch_response& result) { return result.second; }),
@@ -1462,7 +1520,12 @@ namespace nmos
                                 if (req.headers().end() != accept && web::http::details::mime_types::application_json == web::http::details::get_mime_type(accept->second) && U("application/sdp") == nmos::fields::transportfile_type(transportfile))
                                 {
                                     // Experimental extension - SDP as JSON
-                                    set_reply(res, status_codes::OK, sdp::parse_session_description(utility::us2s(data.as_string())));
+                                    // the parsed transport file is cached in the resource until it is next updated, e.g. by an activation
+                                    const auto rendered = resource->serialized.get_rendered(U("transportfile/json"), resource->updated, [&data]
+                                    {
+                                        return sdp::parse_session_description(utility::us2s(data.as_string())).serialize();
+                                    });
+                                    set_reply(res, status_codes::OK, *rendered, web::http::details::mime_types::application_json);
                                 }
                                 else
                                 {
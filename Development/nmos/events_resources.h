@@ -20,6 +20,8 @@ namespace nmos
     // See https://github.com/AMWA-TV/nmos-event-tally/blob/v1.0/APIs/schemas/type.json
     // and https://github.com/AMWA-TV/nmos-event-tally/blob/v1.0/APIs/schemas/event.json
     // For WebSocket connections, subscription and grain resources will also be added
+    // A source may opt in to conflation of its state messages on the Events WebSocket API by setting the experimental "conflate" field
+    // see nmos::experimental::fields::conflate
 
     nmos::resource make_events_source(const nmos::id& id, const web::json::value& state, const web::json::value& type);
 
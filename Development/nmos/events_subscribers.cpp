@@ -0,0 +1,97 @@
+#include "nmos/events_subscribers.h"
+
+#include "nmos/api_utils.h" // for nmos::resourceType_from_type
+#include "nmos/json_fields.h"
+#include "nmos/query_utils.h"
+#include "nmos/resources.h"
+#include "nmos/version.h"
+
+namespace nmos
+{
+    namespace experimental
+    {
+        void events_subscribers::subscribe(const nmos::id& grain_id, const std::set<nmos::id>& source_ids)
+        {
+            unsubscribe(grain_id);
+
+            if (source_ids.empty()) return;
+
+            for (const auto& source_id : source_ids)
+            {
+                by_source[source_id].insert(grain_id);
+            }
+            by_grain[grain_id] = source_ids;
+        }
+
+        void events_subscribers::unsubscribe(const nmos::id& grain_id)
+        {
+            auto found = by_grain.find(grain_id);
+            if (by_grain.end() == found) return;
+
+            for (const auto& source_id : found->second)
+            {
+                auto source = by_source.find(source_id);
+                if (by_source.end() == source) continue;
+                source->second.erase(grain_id);
+                if (source->second.empty()) by_source.erase(source);
+
+                // any latest state yet to be sent is superseded by the connection's sync messages when it resubscribes
+                conflated.erase({ grain_id, source_id });
+            }
+            by_grain.erase(found);
+        }
+
+        const events_subscribers::subscribers_type& events_subscribers::subscribers(const nmos::id& source_id) const
+        {
+            static const subscribers_type none;
+            auto found = by_source.find(source_id);
+            return by_source.end() != found ? found->second : none;
+        }
+
+        void events_subscribers::insert_resource_events(nmos::resources& resources, const nmos::settings& settings, const nmos::type& type, const web::json::value& pre, const web::json::value& post)
+        {
+            // only state changes are dispatched, not the erasure of sources
+            if (nmos::types::source != type || post.is_null()) return;
+
+            const auto& source_id = nmos::fields::id(post);
+            const auto& grain_ids = subscribers(source_id);
+            if (grain_ids.empty()) return;
+
+            // the state message is made from "post" by nmos::send_events_ws_messages_thread
+            auto event = nmos::details::make_resource_event(U('/') + nmos::resourceType_from_type(nmos::types::source), type, web::json::value::null(), post);
+            // the update timestamp of the source identifies this state exactly, so that it need only be rendered once
+            // however many connections it is sent on (see nmos::details::render_events_state)
+            auto source = find_resource(resources, { source_id, type });
+            if (resources.end() != source) event[nmos::fields::version] = web::json::value::string(nmos::make_version(source->updated));
+
+            const bool conflate = nmos::experimental::fields::conflate(post);
+            const auto now = tai_clock::now();
+            const auto conflation_interval = std::chrono::milliseconds(nmos::experimental::fields::events_conflation_interval_ms(settings));
+
+            for (const auto& grain_id : grain_ids)
+            {
+                auto grain = find_resource(resources, { grain_id, nmos::types::grain });
+                if (resources.end() == grain) continue;
+
+                if (conflate)
+                {
+                    auto& conflated_state = conflated[{ grain_id, source_id }];
+
+                    // only the latest state is kept, replacing any which is yet to be sent, unless the interval since a state was last sent has passed
+                    if (!conflated_state.event.is_null() || now < conflated_state.flushed + conflation_interval)
+                    {
+                        conflated_state.event = event;
+                        continue;
+                    }
+                    conflated_state.flushed = now;
+                }
+
+                resources.modify(grain, [&resources, &event](nmos::resource& grain)
+                {
+                    web::json::push_back(nmos::fields::message_grain_data(grain.data), event);
+                    grain.updated = strictly_increasing_update(resources);
+                });
+            }
+        }
+    }
+}
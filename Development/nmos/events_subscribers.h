@@ -0,0 +1,69 @@
+#ifndef NMOS_EVENTS_SUBSCRIBERS_H
+#define NMOS_EVENTS_SUBSCRIBERS_H
+
+#include <map>
+#include <set>
+#include <unordered_map>
+#include "cpprest/json.h"
+#include "nmos/api_version.h"
+#include "nmos/id.h"
+#include "nmos/settings.h"
+#include "nmos/tai.h"
+#include "nmos/type.h"
+
+// This is an experimental extension to dispatch IS-07 state changes to the Events WebSocket API connections subscribed
+// to each source, without matching the subscription of every connection against every change
+namespace nmos
+{
+    struct resources;
+
+    namespace experimental
+    {
+        // index from source id to the Events WebSocket API connections (grain ids) subscribed to it,
+        // used to dispatch each state change, as it is made, to just those connections
+        // (lock the model mutex, for read, to use this, or for write, to modify it)
+        class events_subscribers
+        {
+        public:
+            typedef std::set<nmos::id> subscribers_type;
+
+            // the latest state of a source which has opted in to conflation that is yet to be sent on a connection (or null),
+            // and when a state was last sent
+            struct conflated_state
+            {
+                web::json::value event;
+                tai_clock::time_point flushed;
+            };
+
+            // by grain id and source id
+            typedef std::map<std::pair<nmos::id, nmos::id>, conflated_state> conflated_states_type;
+
+            // replace the sources to which the specified connection is subscribed
+            void subscribe(const nmos::id& grain_id, const std::set<nmos::id>& source_ids);
+
+            // remove the specified connection, e.g. when it is closed or expires
+            void unsubscribe(const nmos::id& grain_id);
+
+            // the connections subscribed to the specified source
+            const subscribers_type& subscribers(const nmos::id& source_id) const;
+
+            bool empty() const { return by_source.empty(); }
+
+            // append the state of an inserted or modified source to the grain of each connection subscribed to it, or for a source which has
+            // opted in to conflation (see nmos::experimental::fields::conflate), replace the latest state yet to be sent on each connection,
+            // unless one can be sent straight away (this is the resource_events_handler of the node model's events_resources)
+            void insert_resource_events(nmos::resources& resources, const nmos::settings& settings, const nmos::type& type, const web::json::value& pre, const web::json::value& post);
+
+            // the latest states yet to be sent, which are flushed by nmos::send_events_ws_messages_thread at most once per events_conflation_interval_ms
+            conflated_states_type& conflated_states() { return conflated; }
+            const conflated_states_type& conflated_states() const { return conflated; }
+
+        private:
+            std::unordered_map<nmos::id, subscribers_type> by_source;
+            std::unordered_map<nmos::id, std::set<nmos::id>> by_grain;
+            conflated_states_type conflated;
+        };
+    }
+}
+
+#endif
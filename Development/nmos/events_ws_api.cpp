@@ -1,5 +1,8 @@
 #include "nmos/events_ws_api.h"
 
+#include <map>
+#include <memory>
+#include <set>
 #include <boost/algorithm/string/join.hpp>
 #include "cpprest/json_storage.h"
 #include "nmos/api_utils.h"
@@ -157,6 +160,8 @@ namespace nmos
                 {
                     slog::log<slog::severities::info>(gate, SLOG_FLF) << "Deleting websocket connection: " << grain->id;
 
+                    model.events_subscribers.unsubscribe(grain->id);
+
                     // subscriptions have a 1-1 relationship with the websocket connection and both should now be erased immediately
                     auto subscription = find_resource(resources, { nmos::fields::subscription_id(grain->data), nmos::types::subscription });
 
@@ -228,14 +233,20 @@ namespace nmos
                                 // update the grain with the current (sync) data for state messages
                                 // without discarding any outstanding events (health messages, for example)
 
-                                resources.modify(grain, [&](nmos::resource& grain)
+                                const auto& resource_path = nmos::fields::resource_path(subscription->data);
+                                const auto& params = nmos::fields::params(subscription->data);
+                                // these resource events are not structured as required for the state message
+                                // so will be transformed in nmos::send_events_ws_messages_thread
+                                auto events = make_resource_events(resources, subscription->version, resource_path, params);
+                                // like the state changes dispatched by nmos::experimental::events_subscribers, each is identified by the update timestamp of the source
+                                for (auto& event : events.as_array())
                                 {
-                                    const auto& resource_path = nmos::fields::resource_path(subscription->data);
-                                    const auto& params = nmos::fields::params(subscription->data);
-                                    // these resource events are not structured as required for the state message
-                                    // so will be transformed in nmos::send_events_ws_messages_thread
-                                    auto events = make_resource_events(resources, subscription->version, resource_path, params);
+                                    auto source = find_resource(resources, { nmos::fields::id(event.at(U("post"))), nmos::types::source });
+                                    if (resources.end() != source) event[nmos::fields::version] = value::string(nmos::make_version(source->updated));
+                                }
 
+                                resources.modify(grain, [&](nmos::resource& grain)
+                                {
                                     auto& events_storage = web::json::storage_of(events.as_array());
                                     auto& grain_storage = web::json::storage_of(nmos::fields::message_grain_data(grain.data).as_array());
                                     if (!grain_storage.empty())
@@ -249,6 +260,14 @@ namespace nmos
                                     grain.updated = strictly_increasing_update(resources);
                                 });
 
+                                // subsequent state changes of these sources are dispatched to this connection
+                                std::set<nmos::id> source_ids;
+                                for (const auto& source_id : nmos::fields::sources(message))
+                                {
+                                    source_ids.insert(source_id.as_string());
+                                }
+                                model.events_subscribers.subscribe(grain->id, source_ids);
+
                                 slog::log<slog::severities::info>(gate, SLOG_FLF) << "Received subscription command for " << nmos::fields::sources(message).size() << " sources";
                                 model.notify();
                             }
@@ -322,20 +341,49 @@ namespace nmos
         });
     }
 
+    namespace details
+    {
+        // state messages already rendered as UTF-8, by source id and the update timestamp of the source when the state was taken
+        typedef std::map<std::pair<nmos::id, nmos::tai>, std::shared_ptr<const std::string>> rendered_events_states;
+
+        // render the state message of the specified resource event, unless the same state of the same source has already been rendered,
+        // since the same state change is usually sent on every connection subscribed to the source
+        // (an event without the update timestamp of the source, see nmos::experimental::events_subscribers::insert_resource_events, is always rendered)
+        std::shared_ptr<const std::string> render_events_state(rendered_events_states& rendered, const web::json::value& event)
+        {
+            const auto& post = event.at(U("post"));
+            const auto& state = nmos::fields::endpoint_state(post);
+            if (!event.has_field(nmos::fields::version))
+            {
+                return std::make_shared<const std::string>(utility::us2s(state.serialize()));
+            }
+
+            auto& rendered_state = rendered[{ nmos::fields::id(post), nmos::fields::version(event) }];
+            if (!rendered_state)
+            {
+                rendered_state = std::make_shared<const std::string>(utility::us2s(state.serialize()));
+            }
+            return rendered_state;
+        }
+    }
+
     void send_events_ws_messages_thread(web::websockets::experimental::listener::websocket_listener& listener, nmos::node_model& model, nmos::websockets& websockets, slog::base_gate& gate_)
     {
         nmos::details::omanip_gate gate(gate_, nmos::stash_category(nmos::categories::send_events_ws_messages));
+        nmos::experimental::mutex_category_guard mutex_category(nmos::categories::send_events_ws_messages);
 
         using web::json::value;
         using web::json::value_of;
 
-        // could start out as a shared/read lock, only upgraded to an exclusive/write lock when a grain in the resources is actually modified
-        auto lock = model.write_lock();
+        // start out as an upgrade lock, shared with readers, only upgraded to an exclusive/write lock when a grain in the resources is actually modified
+        // or a websocket is actually closed
+        auto lock = model.upgrade_lock();
         auto& condition = model.condition;
         auto& shutdown = model.shutdown;
         auto& resources = model.events_resources;
 
         tai most_recent_message{};
+
         auto earliest_necessary_update = (tai_clock::time_point::max)();
 
         for (;;)
@@ -350,8 +398,64 @@ namespace nmos
 
             earliest_necessary_update = (tai_clock::time_point::max)();
 
+            // state changes are dispatched to the grains of the connections subscribed to each source as they are made (see nmos::experimental::events_subscribers)
+            // except for the latest state of each conflated source, which is flushed to each connection here, at most once per conflation interval
+            {
+                const auto now = tai_clock::now();
+                const auto conflation_interval = std::chrono::milliseconds(nmos::experimental::fields::events_conflation_interval_ms(model.settings));
+
+                bool flush = false;
+                for (const auto& conflated : model.events_subscribers.conflated_states())
+                {
+                    const auto& conflated_state = conflated.second;
+                    if (conflated_state.event.is_null()) continue;
+
+                    const auto next_flush = conflated_state.flushed + conflation_interval;
+                    if (next_flush <= now) flush = true;
+                    else if (next_flush < earliest_necessary_update) earliest_necessary_update = next_flush;
+                }
+
+                if (flush)
+                {
+                    nmos::upgrade_to_write_lock upgrade(lock);
+
+                    auto& conflated_states = model.events_subscribers.conflated_states();
+                    for (auto it = conflated_states.begin(); conflated_states.end() != it;)
+                    {
+                        auto& conflated_state = it->second;
+                        if (conflated_state.event.is_null() || now < conflated_state.flushed + conflation_interval)
+                        {
+                            ++it;
+                            continue;
+                        }
+
+                        auto grain = find_resource(resources, { it->first.first, nmos::types::grain });
+                        if (resources.end() == grain)
+                        {
+                            it = conflated_states.erase(it);
+                            continue;
+                        }
+
+                        resources.modify(grain, [&resources, &conflated_state](nmos::resource& grain)
+                        {
+                            web::json::push_back(nmos::fields::message_grain_data(grain.data), std::move(conflated_state.event));
+                            grain.updated = strictly_increasing_update(resources);
+                        });
+                        conflated_state.event = value::null();
+                        conflated_state.flushed = now;
+
+                        // make sure to flush any further changes as soon as allowed
+                        if (now + conflation_interval < earliest_necessary_update) earliest_necessary_update = now + conflation_interval;
+                        ++it;
+                    }
+                }
+            }
+
             std::vector<std::pair<web::websockets::experimental::listener::connection_id, web::websockets::websocket_outgoing_message>> outgoing_messages;
 
+            // each state change is rendered just once in each pass, however many connections it is sent on
+            details::rendered_events_states rendered_states;
+
             for (auto wit = websockets.left.begin(); websockets.left.end() != wit;)
             {
                 const auto& websocket = *wit;
@@ -360,6 +464,10 @@ namespace nmos
                 const auto grain = find_resource(resources, { websocket.first, nmos::types::grain });
                 if (resources.end() == grain)
                 {
+                    nmos::upgrade_to_write_lock upgrade(lock);
+
+                    model.events_subscribers.unsubscribe(websocket.first);
+
                     // theoretically blocking, but in fact not
                     listener.close(websocket.second, web::websockets::websocket_close_status::server_terminate, U("Expired")).wait();
 
@@ -369,7 +477,10 @@ namespace nmos
                 const auto subscription = find_resource(resources, { nmos::fields::subscription_id(grain->data), nmos::types::subscription });
                 if (resources.end() == subscription)
                 {
+                    nmos::upgrade_to_write_lock upgrade(lock);
+
                     // a grain without a subscription shouldn't be possible, but let's be tidy
+                    model.events_subscribers.unsubscribe(grain->id);
                     erase_resource(resources, grain->id);
 
                     // theoretically blocking, but in fact not
@@ -403,25 +514,28 @@ namespace nmos
                         // see https://github.com/AMWA-TV/nmos-event-tally/blob/v1.0/docs/2.0.%20Message%20types.md#11-the-state-message-type
                         // and nmos::make_events_boolean_state, nmos::make_events_number_state, etc.
                         // and nmos::details::make_resource_event
-                        const web::json::value& state = nmos::fields::endpoint_state(event.at(U("post")));
-                        message.set_utf8_message(utility::us2s(state.serialize()));
+                        message.set_utf8_message(*details::render_events_state(rendered_states, event));
                         outgoing_messages.push_back({ websocket.second, message });
                     }
                 }
 
                 // reset the grain for next time
-                resources.modify(grain, [&resources](nmos::resource& grain)
                 {
-                    // all messages have now been prepared
-                    nmos::fields::message_grain_data(grain.data) = value::array();
-                    grain.updated = strictly_increasing_update(resources);
-                });
+                    nmos::upgrade_to_write_lock upgrade(lock);
+
+                    resources.modify(grain, [&resources](nmos::resource& grain)
+                    {
+                        // all messages have now been prepared
+                        nmos::fields::message_grain_data(grain.data) = value::array();
+                        grain.updated = strictly_increasing_update(resources);
+                    });
+                }
 
                 ++wit;
             }
 
             // send the messages without the lock on resources
-            details::reverse_lock_guard<nmos::write_lock> unlock{ lock };
+            details::reverse_lock_guard<nmos::upgrade_lock> unlock{ lock };
 
             if (!outgoing_messages.empty()) slog::log<slog::severities::info>(gate, SLOG_FLF) << "Sending " << outgoing_messages.size() << " websocket messages";
 
@@ -449,9 +563,10 @@ namespace nmos
     void erase_expired_events_resources_thread(nmos::node_model& model, slog::base_gate& gate_)
     {
         nmos::details::omanip_gate gate(gate_, nmos::stash_category(nmos::categories::events_expiry));
+        nmos::experimental::mutex_category_guard mutex_category(nmos::categories::events_expiry);
 
-        // start out as a shared/read lock, only upgraded to an exclusive/write lock when an expired resource actually needs to be deleted from the resources
-        auto lock = model.read_lock();
+        // start out as an upgrade lock, shared with readers, only upgraded to an exclusive/write lock when an expired resource actually needs to be deleted from the resources
+        auto lock = model.upgrade_lock();
         auto& shutdown_condition = model.shutdown_condition;
         auto& shutdown = model.shutdown;
         auto& resources = model.events_resources;
@@ -474,18 +589,15 @@ namespace nmos
 
             // otherwise, there's actually work to do...
 
-            details::reverse_lock_guard<nmos::read_lock> unlock(lock);
-            // note, without atomic upgrade, another thread may preempt hence the need to recalculate expire_health/forget_health and least_health
-            auto upgrade = model.write_lock();
-
-            expire_health = health_now() - nmos::fields::events_expiry_interval(model.settings);
-            forget_health = expire_health - nmos::fields::events_expiry_interval(model.settings);
+            // the upgrade is atomic, so no other thread can have modified the resources in the meantime
+            nmos::upgrade_to_write_lock upgrade(lock);
 
             // forget all resources expired in the previous interval
             forget_erased_resources(resources, forget_health);
 
             // expire all nodes for which there hasn't been a heartbeat in the last expiry interval
             const auto expired = erase_expired_resources(resources, expire_health, false);
+            model.metrics.resources_expired += expired;
 
             if (0 != expired)
             {
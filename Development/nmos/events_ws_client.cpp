@@ -10,6 +10,7 @@
 #include "pplx/pplx_utils.h" // for pplx::complete_after, etc.
 #include "nmos/client_utils.h"
 #include "nmos/events_resources.h"
+#include "nmos/json_fields.h"
 #include "nmos/mutex.h"
 #include "nmos/slog.h"
 
@@ -66,6 +67,115 @@ namespace nmos
 {
     namespace details
     {
+        events_ws_message_router::events_ws_message_router(slog::base_gate& gate)
+            : gate(gate)
+            , asynchronous(false)
+        {
+        }
+
+        events_ws_message_router::~events_ws_message_router()
+        {
+            wait();
+        }
+
+        void events_ws_message_router::set_message_handler(events_ws_message_handler message_handler)
+        {
+            auto lock = nmos::write_lock{ mutex };
+            default_handler = message_handler;
+        }
+
+        void events_ws_message_router::set_source_message_handler(const nmos::id& source_id, events_ws_message_handler message_handler)
+        {
+            auto lock = nmos::write_lock{ mutex };
+            if (message_handler) source_handlers[source_id] = message_handler; else source_handlers.erase(source_id);
+        }
+
+        void events_ws_message_router::set_asynchronous(bool asynchronous_)
+        {
+            asynchronous = asynchronous_;
+        }
+
+        void events_ws_message_router::route(const web::uri& connection_uri, const std::string& msg)
+        {
+            try
+            {
+                const auto message = std::make_shared<const web::json::value>(web::json::value::parse(utility::conversions::to_string_t(msg)));
+
+                // "state", "reboot" and "shutdown" messages identify their source, "health" messages do not
+                // see https://github.com/AMWA-TV/nmos-event-tally/blob/v1.0/docs/2.0.%20Message%20types.md
+                nmos::id source_id;
+                if (message->has_field(nmos::fields::identity))
+                {
+                    const auto& identity = nmos::fields::identity(*message);
+                    if (identity.has_field(nmos::fields::source_id)) source_id = nmos::fields::source_id(identity);
+                }
+
+                if (!asynchronous)
+                {
+                    // the handler is copied, and called once the lock has been released, so that it may itself set or remove handlers
+                    events_ws_message_handler handler;
+                    {
+                        auto lock = nmos::read_lock{ mutex };
+
+                        auto source_handler = source_handlers.find(source_id);
+                        handler = source_handlers.end() != source_handler ? source_handler->second : default_handler;
+                    }
+
+                    if (handler)
+                    {
+                        handler(connection_uri, *message);
+                    }
+                    return;
+                }
+
+                auto lock = nmos::write_lock{ mutex };
+
+                auto source_handler = source_handlers.find(source_id);
+                const auto handler = source_handlers.end() != source_handler ? source_handler->second : default_handler;
+                if (!handler) return;
+
+                // each handler is chained after the previous one for the same source, so that messages from each source are handled in order
+                auto source_task = source_tasks.find(source_id);
+                if (source_tasks.end() == source_task) source_task = source_tasks.insert({ source_id, pplx::task_from_result() }).first;
+
+                source_task->second = source_task->second.then([this, handler, connection_uri, message]
+                {
+                    try
+                    {
+                        handler(connection_uri, *message);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        slog::log<slog::severities::error>(gate, SLOG_FLF) << "Unexpected exception in message handler: " << e.what();
+                    }
+                    catch (...)
+                    {
+                        slog::log<slog::severities::severe>(gate, SLOG_FLF) << "Unexpected unknown exception in message handler";
+                    }
+                });
+            }
+            catch (const web::json::json_exception& e)
+            {
+                slog::log<slog::severities::warning>(gate, SLOG_FLF) << "JSON error: " << e.what();
+
+                // sending an error message back at this point would be nice?
+                // should the connection be closed and re-opened?
+            }
+        }
+
+        void events_ws_message_router::wait()
+        {
+            std::vector<pplx::task<void>> tasks;
+            {
+                auto lock = nmos::read_lock{ mutex };
+                for (const auto& source_task : source_tasks) tasks.push_back(source_task.second);
+            }
+            for (auto& task : tasks)
+            {
+                try { task.wait(); } catch (...) {}
+            }
+        }
+
         struct events_ws_client_impl
         {
             events_ws_client_impl(web::websockets::client::websocket_client_config config, int events_heartbeat_interval, slog::base_gate& gate);
@@ -81,7 +191,8 @@ namespace nmos
 
             events_ws_close_handler user_close;
 
-            events_ws_message_handler user_message;
+            // external message handlers are only called once for each message, no matter how many receivers are subscribed to sources on the connection
+            events_ws_message_router router;
 
             events_ws_subscriptions subscriptions;
 
@@ -100,6 +211,7 @@ namespace nmos
             : config(std::move(config))
             , events_heartbeat_interval(events_heartbeat_interval)
             , gate(make_gate(gate))
+            , router(this->gate)
         {
         }
 
@@ -191,31 +303,7 @@ namespace nmos
                         // theoretically blocking, but in fact not
                         msg.extract_string().then([this, connection_uri](const std::string& msg)
                         {
-                            try
-                            {
-                                const auto message = web::json::value::parse(utility::conversions::to_string_t(msg));
-
-                                // external message handler is only called once for each message, no matter how many receivers are subscribed to sources on this connection
-
-                                // hmm, if the user wanted to implement subscription-specific behaviour for "shutdown", "reboot" and especially "state" messages (events),
-                                // the callback might be simplified by passing a set of ids associated with the message source id, or perhaps a boost::any_range of the
-                                // relevant event_ws_subscriptions, or access to the subscriptions member itself protected by the mutex
-                                // ("heartbeat" messages are not source-specific so those could be handled separately; the user is less likely to be interested anyway...)
-
-                                auto lock = read_lock();
-
-                                if (user_message)
-                                {
-                                    user_message(connection_uri, message);
-                                }
-                            }
-                            catch (const web::json::json_exception& e)
-                            {
-                                slog::log<slog::severities::warning>(gate, SLOG_FLF) << "JSON error: " << e.what();
-
-                                // sending an error message back at this point would be nice?
-                                // should the connection be closed and re-opened?
-                            }
+                            router.route(connection_uri, msg);
                         }).wait();
                     });
 
@@ -421,8 +509,17 @@ namespace nmos
 
     void events_ws_client::set_message_handler(events_ws_message_handler message_handler)
     {
-        // updating the close handler with open connections is not supported, so no lock
-        impl->user_message = message_handler;
+        impl->router.set_message_handler(message_handler);
+    }
+
+    void events_ws_client::set_source_message_handler(const nmos::id& source_id, events_ws_message_handler message_handler)
+    {
+        impl->router.set_source_message_handler(source_id, message_handler);
+    }
+
+    void events_ws_client::set_asynchronous_message_handlers(bool asynchronous)
+    {
+        impl->router.set_asynchronous(asynchronous);
     }
 
     const web::websockets::client::websocket_client_config& events_ws_client::configuration() const
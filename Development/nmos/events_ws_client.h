@@ -1,8 +1,11 @@
 #ifndef NMOS_EVENTS_WS_CLIENT_H
 #define NMOS_EVENTS_WS_CLIENT_H
 
+#include <atomic>
+#include <unordered_map>
 #include "cpprest/ws_client.h" // for web::websockets::client::websocket_close_status, etc.
 #include "nmos/id.h" // forward declaration
+#include "nmos/mutex.h"
 
 namespace web
 {
@@ -29,6 +32,47 @@ namespace nmos
     // an events_ws_message_handler callback indicates the specified message has been received on the specified connection 
     typedef std::function<void(const web::uri& connection_uri, const web::json::value& message)> events_ws_message_handler;
 
+    namespace details
+    {
+        // routes each message received on an Events WebSocket API connection, which is parsed just once, to the handler for its source, if any,
+        // or otherwise to the default handler
+        // the handlers may be called asynchronously, on the task scheduler's thread pool, in which case messages from each source are still handled in order
+        class events_ws_message_router
+        {
+        public:
+            explicit events_ws_message_router(slog::base_gate& gate);
+            ~events_ws_message_router();
+
+            void set_message_handler(events_ws_message_handler message_handler);
+
+            // an empty handler removes the handler for the specified source
+            void set_source_message_handler(const nmos::id& source_id, events_ws_message_handler message_handler);
+
+            void set_asynchronous(bool asynchronous);
+
+            // parse the specified message and call the appropriate handler
+            void route(const web::uri& connection_uri, const std::string& message);
+
+            // wait for any asynchronous handlers to complete
+            void wait();
+
+        private:
+            events_ws_message_router(const events_ws_message_router& other);
+            events_ws_message_router& operator=(const events_ws_message_router& other);
+
+            slog::base_gate& gate;
+
+            mutable nmos::mutex mutex;
+
+            events_ws_message_handler default_handler;
+            std::unordered_map<nmos::id, events_ws_message_handler> source_handlers;
+
+            std::atomic<bool> asynchronous;
+            // the most recent asynchronous handler for each source (or for messages without a source, such as "health")
+            std::unordered_map<nmos::id, pplx::task<void>> source_tasks;
+        };
+    }
+
     // an events_ws_close_handler callback indicates the connection to the specified WebSocket URI has been closed with the specified status and reason
     typedef std::function<void(const web::uri& connection_uri, web::websockets::client::websocket_close_status close_status, const utility::string_t& close_reason)> events_ws_close_handler;
 
@@ -59,6 +103,14 @@ namespace nmos
 
         void set_message_handler(events_ws_message_handler message_handler);
 
+        // set the handler for "state", "reboot" and "shutdown" messages from the specified source, which is called instead of the message handler for those messages
+        // (an empty handler removes it)
+        void set_source_message_handler(const nmos::id& source_id, events_ws_message_handler message_handler);
+
+        // call the message handlers asynchronously, on the task scheduler's thread pool, so that a slow handler doesn't hold up receiving messages
+        // messages from each source are still handled in order
+        void set_asynchronous_message_handlers(bool asynchronous);
+
         const web::websockets::client::websocket_client_config& configuration() const;
 
         events_ws_client(events_ws_client&& other);
@@ -192,6 +192,11 @@ namespace nmos
         namespace fields
         {
             const web::json::field<nmos::api_version> api_version{ U("api_version") };
+
+            // IS-07 sources for which only the latest state is sent on each Events WebSocket API connection, at most once per events_conflation_interval_ms
+            // e.g. for high-rate sources such as audio level meters, where intermediate states may be discarded
+            // (health, reboot and shutdown messages are not affected)
+            const web::json::field_as_bool_or conflate{ U("conflate"), false };
         }
     }
 }
@@ -97,6 +97,9 @@ namespace nmos
             {
                 auto lock = model.write_lock();
 
+                // the async_log_service stashes the number of messages it had to discard before this one
+                model.discarded += slog::get_stash<slog::async_log_discarded_tag>(message.stream(), 0);
+
                 auto categories = nmos::get_categories_stash(message.stream());
 
                 if (pertinent(message.level()) && pertinent(categories))
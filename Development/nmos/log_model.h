@@ -67,6 +67,9 @@ namespace nmos
             // log events themselves
             nmos::experimental::log_events events;
 
+            // number of log messages discarded because the asynchronous logging queue was full
+            std::atomic<std::uint64_t> discarded{ 0 };
+
             // convenience functions
 
             nmos::read_lock read_lock() const { return nmos::read_lock{ mutex }; }
@@ -0,0 +1,142 @@
+#ifndef NMOS_METRICS_H
+#define NMOS_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include "cpprest/api_router.h" // for web::http::experimental::listener::route_statistics_handler
+
+// This is an experimental extension to record operational metrics, exposed via the Metrics API
+namespace nmos
+{
+    namespace experimental
+    {
+        // histogram of durations, with fixed bucket upper bounds, which may be recorded concurrently without locking
+        // (the buckets, count and sum are not updated atomically as a whole, so a snapshot may be very slightly inconsistent)
+        // this is used for API request latencies and for model mutex wait and hold durations, so the bounds start from 1 us
+        class duration_histogram
+        {
+        public:
+            // the number of buckets with a finite upper bound, the last bucket being "+Inf"
+            static const std::size_t bucket_count = 20;
+
+            // bucket upper bounds in seconds
+            static double bucket_upper_bound(std::size_t bucket)
+            {
+                static const double bounds[bucket_count] = { 0.000001, 0.0000025, 0.000005, 0.00001, 0.000025, 0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5 };
+                return bounds[bucket];
+            }
+
+            duration_histogram() : buckets(), count_(0), sum_(0) {}
+            // copying takes a snapshot
+            duration_histogram(const duration_histogram& other) : buckets(), count_(0), sum_(0) { *this = other; }
+            duration_histogram& operator=(const duration_histogram& other)
+            {
+                for (std::size_t bucket = 0; bucket <= bucket_count; ++bucket) buckets[bucket].store(other.bucket(bucket), std::memory_order_relaxed);
+                count_.store(other.count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                sum_.store(other.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                return *this;
+            }
+
+            void record(std::chrono::steady_clock::duration duration)
+            {
+                const auto seconds = std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+                std::size_t bucket = 0;
+                while (bucket < bucket_count && seconds > bucket_upper_bound(bucket)) ++bucket;
+                buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+                count_.fetch_add(1, std::memory_order_relaxed);
+                sum_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), std::memory_order_relaxed);
+            }
+
+            // non-cumulative count of the specified bucket, in the range [0, bucket_count]
+            std::uint64_t bucket(std::size_t bucket) const { return buckets[bucket].load(std::memory_order_relaxed); }
+            std::uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+            // sum in seconds
+            double sum() const { return std::chrono::duration<double>(std::chrono::nanoseconds(sum_.load(std::memory_order_relaxed))).count(); }
+
+        private:
+            std::array<std::atomic<std::uint64_t>, bucket_count + 1> buckets;
+            std::atomic<std::uint64_t> count_;
+            std::atomic<std::int64_t> sum_;
+        };
+
+        // record the time from construction to destruction in the specified histogram
+        class duration_recorder
+        {
+        public:
+            explicit duration_recorder(duration_histogram& histogram) : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+            ~duration_recorder() { histogram.record(std::chrono::steady_clock::now() - start); }
+            duration_recorder(const duration_recorder&) = delete;
+            duration_recorder& operator=(const duration_recorder&) = delete;
+        private:
+            duration_histogram& histogram;
+            std::chrono::steady_clock::time_point start;
+        };
+
+        // route statistics are request counts and latency histograms per route pattern, method and status code, recorded by the api_router
+        // of each HTTP API via the handler made by make_route_statistics_handler
+        class route_statistics
+        {
+        public:
+            typedef std::tuple<utility::string_t, web::http::method, web::http::status_code> key_type;
+            typedef std::map<key_type, duration_histogram> histograms_type;
+
+            void record(const utility::string_t& route_pattern, const web::http::method& method, web::http::status_code status_code, std::chrono::steady_clock::duration duration)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                histograms_[key_type{ route_pattern, method, status_code }].record(duration);
+            }
+
+            histograms_type histograms() const
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                return histograms_;
+            }
+
+        private:
+            mutable std::mutex mutex;
+            histograms_type histograms_;
+        };
+
+        inline web::http::experimental::listener::route_statistics_handler make_route_statistics_handler(std::shared_ptr<route_statistics> statistics)
+        {
+            return [statistics](const utility::string_t& route_pattern, const web::http::method& method, web::http::status_code status_code, std::chrono::steady_clock::duration duration)
+            {
+                statistics->record(route_pattern, method, status_code, duration);
+            };
+        }
+
+        typedef std::atomic<std::uint64_t> metrics_counter;
+
+        // counters and histograms which are not derived from the other members of the model
+        // these may be updated while holding only a read lock (or none at all), since they are atomic
+        struct metrics
+        {
+            // Registration API requests to create, update and delete resources, and heartbeats
+            metrics_counter registrations_created{ 0 };
+            metrics_counter registrations_updated{ 0 };
+            metrics_counter registrations_deleted{ 0 };
+            metrics_counter heartbeats{ 0 };
+
+            // resources deleted due to expiry of the node or the websocket connection
+            metrics_counter resources_expired{ 0 };
+
+            // time taken to handle Query API requests for resources
+            duration_histogram query_api_duration;
+
+            // Query API requests for resources which were, or were not, satisfied from the result cache
+            metrics_counter query_cache_hits{ 0 };
+            metrics_counter query_cache_misses{ 0 };
+
+            // request counts and latencies per route pattern, method and status code, for all the HTTP APIs
+            const std::shared_ptr<route_statistics> routes = std::make_shared<route_statistics>();
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,247 @@
+#include "nmos/metrics_api.h"
+
+#include <functional>
+#include <sstream>
+#include <vector>
+#include "nmos/api_utils.h"
+#include "nmos/log_model.h"
+#include "nmos/model.h"
+#include "nmos/query_utils.h" // for nmos::fields::message_grain_data
+#include "nmos/slog.h"
+
+namespace nmos
+{
+    namespace experimental
+    {
+        namespace details
+        {
+            // label values may contain any Unicode characters, but backslash, double-quote and line feed must be escaped
+            inline std::string escape_label_value(const std::string& value)
+            {
+                std::string result;
+                result.reserve(value.size());
+                for (const auto c : value)
+                {
+                    switch (c)
+                    {
+                    case '\\': result += "\\\\"; break;
+                    case '"': result += "\\\""; break;
+                    case '\n': result += "\\n"; break;
+                    default: result += c; break;
+                    }
+                }
+                return result;
+            }
+
+            typedef std::vector<std::pair<std::string, std::string>> metric_labels;
+
+            inline std::ostream& put_labels(std::ostream& os, const metric_labels& labels)
+            {
+                if (labels.empty()) return os;
+                os << '{';
+                bool first = true;
+                for (const auto& label : labels)
+                {
+                    if (!first) os << ',';
+                    first = false;
+                    os << label.first << "=\"" << escape_label_value(label.second) << '"';
+                }
+                return os << '}';
+            }
+
+            // each metric family must be introduced just once, before all its samples
+            inline void put_metric_family(std::ostream& os, const std::string& name, const std::string& type, const std::string& help)
+            {
+                os << "# HELP " << name << ' ' << help << '\n';
+                os << "# TYPE " << name << ' ' << type << '\n';
+            }
+
+            template <typename Value>
+            inline void put_sample(std::ostream& os, const std::string& name, const metric_labels& labels, const Value& value)
+            {
+                put_labels(os << name, labels) << ' ' << value << '\n';
+            }
+
+            // bucket_count finite buckets, with non-cumulative counts from bucket(i) and upper bounds in seconds from upper_bound(i)
+            // and a final "+Inf" bucket, bucket(bucket_count)
+            template <typename UpperBound, typename Bucket>
+            inline void put_histogram_samples(std::ostream& os, const std::string& name, const metric_labels& labels, std::size_t bucket_count, UpperBound upper_bound, Bucket bucket, double sum)
+            {
+                std::uint64_t cumulative_count = 0;
+                for (std::size_t i = 0; i <= bucket_count; ++i)
+                {
+                    cumulative_count += bucket(i);
+
+                    std::ostringstream le;
+                    if (bucket_count != i) le << upper_bound(i); else le << "+Inf";
+
+                    auto bucket_labels = labels;
+                    bucket_labels.push_back({ "le", le.str() });
+                    put_sample(os, name + "_bucket", bucket_labels, cumulative_count);
+                }
+                put_sample(os, name + "_sum", labels, sum);
+                put_sample(os, name + "_count", labels, cumulative_count);
+            }
+
+            inline void put_histogram_samples(std::ostream& os, const std::string& name, const metric_labels& labels, const duration_histogram& histogram)
+            {
+                put_histogram_samples(os, name, labels, duration_histogram::bucket_count,
+                    &duration_histogram::bucket_upper_bound,
+                    [&](std::size_t i) { return histogram.bucket(i); },
+                    histogram.sum());
+            }
+
+            // resource counts by type, for the specified resources, e.g. "registry", "node", "connection" or "events"
+            // (lock the model mutex, for read, before calling this)
+            void put_resources_samples(std::ostream& os, const std::string& name, const nmos::resources& resources)
+            {
+                auto& by_type = resources.get<nmos::tags::type>();
+                for (const auto& type : nmos::types::all)
+                {
+                    put_sample(os, "nmos_resources", { { "resources", name }, { "type", utility::us2s(type.name) } }, by_type.count(nmos::details::has_data(type)));
+                }
+                put_sample(os, "nmos_resources", { { "resources", name }, { "type", "" } }, by_type.count(false));
+            }
+
+            // number of websocket connections, and events queued for them
+            // (lock the model mutex, for read, before calling this)
+            void put_websockets_samples(std::ostream& os, const std::string& api, const nmos::websockets& websockets, const nmos::resources& resources)
+            {
+                std::size_t queued = 0;
+                auto& by_type = resources.get<nmos::tags::type>();
+                const auto grains = by_type.equal_range(nmos::details::has_data(nmos::types::grain));
+                for (auto grain = grains.first; grains.second != grain; ++grain)
+                {
+                    queued += nmos::fields::message_grain_data(grain->data).size();
+                }
+
+                put_metric_family(os, "nmos_websocket_connections", "gauge", "Number of WebSocket connections");
+                put_sample(os, "nmos_websocket_connections", { { "api", api } }, websockets.size());
+                put_metric_family(os, "nmos_websocket_queued_events", "gauge", "Number of events queued to be sent on WebSocket connections");
+                put_sample(os, "nmos_websocket_queued_events", { { "api", api } }, queued);
+            }
+
+            // counters and histograms, none of which require the model mutex to be locked
+            void put_metrics_samples(std::ostream& os, const nmos::base_model& model, const nmos::experimental::log_model& log_model)
+            {
+                static const std::string kinds[lock_kind_count] = { "shared", "upgrade", "exclusive" };
+
+                const auto& metrics = model.metrics;
+
+                put_metric_family(os, "nmos_registration_requests_total", "counter", "Number of Registration API requests to create, update or delete resources");
+                put_sample(os, "nmos_registration_requests_total", { { "operation", "create" } }, metrics.registrations_created.load());
+                put_sample(os, "nmos_registration_requests_total", { { "operation", "update" } }, metrics.registrations_updated.load());
+                put_sample(os, "nmos_registration_requests_total", { { "operation", "delete" } }, metrics.registrations_deleted.load());
+
+                put_metric_family(os, "nmos_heartbeats_total", "counter", "Number of Registration API heartbeats");
+                put_sample(os, "nmos_heartbeats_total", {}, metrics.heartbeats.load());
+
+                put_metric_family(os, "nmos_resources_expired_total", "counter", "Number of resources deleted due to expiry");
+                put_sample(os, "nmos_resources_expired_total", {}, metrics.resources_expired.load());
+
+                put_metric_family(os, "nmos_query_api_request_duration_seconds", "histogram", "Time taken to handle Query API requests for resources");
+                put_histogram_samples(os, "nmos_query_api_request_duration_seconds", {}, metrics.query_api_duration);
+
+                put_metric_family(os, "nmos_query_api_cache_requests_total", "counter", "Number of Query API requests for resources by whether the result was cached");
+                put_sample(os, "nmos_query_api_cache_requests_total", { { "result", "hit" } }, metrics.query_cache_hits.load());
+                put_sample(os, "nmos_query_api_cache_requests_total", { { "result", "miss" } }, metrics.query_cache_misses.load());
+
+                put_metric_family(os, "nmos_http_request_duration_seconds", "histogram", "Time taken to handle HTTP API requests by route pattern, method and status code");
+                for (const auto& route : metrics.routes->histograms())
+                {
+                    put_histogram_samples(os, "nmos_http_request_duration_seconds", {
+                            { "route", utility::us2s(std::get<0>(route.first)) },
+                            { "method", utility::us2s(std::get<1>(route.first)) },
+                            { "status", std::to_string(std::get<2>(route.first)) }
+                        },
+                        route.second);
+                }
+
+                put_metric_family(os, "nmos_log_messages_discarded_total", "counter", "Number of log messages discarded because the logging queue was full");
+                put_sample(os, "nmos_log_messages_discarded_total", {}, log_model.discarded.load());
+
+                // lock statistics are only recorded when enabled by the mutex_statistics setting
+                const auto statistics = model.mutex.statistics();
+
+                put_metric_family(os, "nmos_mutex_wait_seconds", "histogram", "Time spent waiting to lock the model mutex");
+                for (const auto& category : statistics)
+                {
+                    for (int kind = 0; kind < lock_kind_count; ++kind)
+                    {
+                        if (0 == category.second[kind].wait.count()) continue;
+                        put_histogram_samples(os, "nmos_mutex_wait_seconds", { { "category", category.first }, { "kind", kinds[kind] } }, category.second[kind].wait);
+                    }
+                }
+
+                put_metric_family(os, "nmos_mutex_hold_seconds", "histogram", "Time for which the model mutex was held");
+                for (const auto& category : statistics)
+                {
+                    for (int kind = 0; kind < lock_kind_count; ++kind)
+                    {
+                        if (0 == category.second[kind].hold.count()) continue;
+                        put_histogram_samples(os, "nmos_mutex_hold_seconds", { { "category", category.first }, { "kind", kinds[kind] } }, category.second[kind].hold);
+                    }
+                }
+            }
+
+            typedef std::function<void(std::ostream&)> metrics_function;
+
+            web::http::experimental::listener::api_router make_metrics_api(metrics_function put_metrics, slog::base_gate& gate)
+            {
+                using namespace web::http::experimental::listener::api_router_using_declarations;
+
+                api_router metrics_api;
+
+                metrics_api.support(U("/?"), methods::GET, [](http_request req, http_response res, const string_t&, const route_parameters&)
+                {
+                    set_reply(res, status_codes::OK, nmos::make_sub_routes_body({ U("metrics/") }, req, res));
+                    return pplx::task_from_result(true);
+                });
+
+                metrics_api.support(U("/metrics/?"), methods::GET, [put_metrics](http_request, http_response res, const string_t&, const route_parameters&)
+                {
+                    std::ostringstream os;
+                    os.precision(9);
+                    put_metrics(os);
+
+                    set_reply(res, status_codes::OK, utility::s2us(os.str()), U("text/plain; version=0.0.4; charset=utf-8"));
+                    return pplx::task_from_result(true);
+                });
+
+                return metrics_api;
+            }
+        }
+
+        web::http::experimental::listener::api_router make_metrics_api(const nmos::registry_model& model, const nmos::websockets& query_websockets, const nmos::experimental::log_model& log_model, slog::base_gate& gate)
+        {
+            return details::make_metrics_api([&model, &query_websockets, &log_model](std::ostream& os)
+            {
+                details::put_metrics_samples(os, model, log_model);
+
+                auto lock = model.read_lock();
+
+                details::put_metric_family(os, "nmos_resources", "gauge", "Number of resources by type, or non-extant resources which are yet to be forgotten (empty type)");
+                details::put_resources_samples(os, "registry", model.registry_resources);
+
+                details::put_websockets_samples(os, "query", query_websockets, model.registry_resources);
+            }, gate);
+        }
+
+        web::http::experimental::listener::api_router make_metrics_api(const nmos::node_model& model, const nmos::websockets& events_websockets, const nmos::experimental::log_model& log_model, slog::base_gate& gate)
+        {
+            return details::make_metrics_api([&model, &events_websockets, &log_model](std::ostream& os)
+            {
+                details::put_metrics_samples(os, model, log_model);
+
+                auto lock = model.read_lock();
+
+                details::put_metric_family(os, "nmos_resources", "gauge", "Number of resources by type, or non-extant resources which are yet to be forgotten (empty type)");
+                details::put_resources_samples(os, "node", model.node_resources);
+                details::put_resources_samples(os, "connection", model.connection_resources);
+                details::put_resources_samples(os, "events", model.events_resources);
+
+                details::put_websockets_samples(os, "events", events_websockets, model.events_resources);
+            }, gate);
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef NMOS_METRICS_API_H
+#define NMOS_METRICS_API_H
+
+#include "cpprest/api_router.h"
+#include "nmos/websockets.h"
+
+namespace slog
+{
+    class base_gate;
+}
+
+// This is an experimental extension to expose operational metrics in the Prometheus text exposition format
+// See https://prometheus.io/docs/instrumenting/exposition_formats/#text-based-format
+namespace nmos
+{
+    struct node_model;
+    struct registry_model;
+
+    namespace experimental
+    {
+        struct log_model;
+
+        // collecting the metrics only requires a read lock on the model, and none at all for the counters and lock statistics
+
+        // registry metrics, including those for the Registration API, Query API and Query WebSocket API
+        web::http::experimental::listener::api_router make_metrics_api(const nmos::registry_model& model, const nmos::websockets& query_websockets, const nmos::experimental::log_model& log_model, slog::base_gate& gate);
+
+        // node metrics, including those for the Events WebSocket API
+        web::http::experimental::listener::api_router make_metrics_api(const nmos::node_model& model, const nmos::websockets& events_websockets, const nmos::experimental::log_model& log_model, slog::base_gate& gate);
+    }
+}
+
+#endif
@@ -1,8 +1,11 @@
 #ifndef NMOS_MODEL_H
 #define NMOS_MODEL_H
 
+#include "nmos/events_subscribers.h"
+#include "nmos/metrics.h"
 #include "nmos/mutex.h"
 #include "nmos/resources.h"
+#include "nmos/resources_snapshot.h"
 #include "nmos/settings.h"
 #include "nmos/thread_utils.h"
 
@@ -28,10 +31,15 @@ namespace nmos
         // flag indicating whether shutdown has been initiated
         bool shutdown = false;
 
+        // operational metrics, exposed via the experimental Metrics API
+        // (these are atomic so may be updated while only holding a read lock)
+        mutable nmos::experimental::metrics metrics;
+
         // convenience functions
         // (the mutex and conditions may be used directly as well)
 
         nmos::read_lock read_lock() const { return nmos::read_lock{ mutex }; }
+        nmos::upgrade_lock upgrade_lock() const { return nmos::upgrade_lock{ mutex }; }
         nmos::write_lock write_lock() const { return nmos::write_lock{ mutex }; }
         void notify() const { return condition.notify_all(); }
 
@@ -90,6 +98,16 @@ namespace nmos
 
     struct node_model : model
     {
+        node_model()
+        {
+            // experimental extension, state changes of the IS-07 sources are dispatched to the Events WebSocket API connections subscribed to each one
+            // see nmos::experimental::events_subscribers
+            events_resources.resource_events_handler = [this](nmos::resources& resources, const nmos::api_version&, const nmos::api_version&, const nmos::type& type, const web::json::value& pre, const web::json::value& post)
+            {
+                events_subscribers.insert_resource_events(resources, settings, type, pre, post);
+            };
+        }
+
         // IS-05 senders and receivers for this node
         // see nmos/connection_resources.h
         nmos::resources connection_resources;
@@ -97,6 +115,11 @@ namespace nmos
         // IS-07 sources for this node
         // see nmos/events_resources.h
         nmos::resources events_resources;
+
+        // experimental extension, index of the Events WebSocket API connections subscribed to each source
+        // which is used to dispatch the state changes of events_resources as they are made
+        // see nmos::experimental::events_subscribers
+        nmos::experimental::events_subscribers events_subscribers;
     };
 
     struct registry_model : model
@@ -104,6 +127,10 @@ namespace nmos
         // Resources added by IS-04 Registration API
         nmos::resources registry_resources;
 
+        // experimental extension, snapshots of the registry resources which can be used without holding the mutex
+        // see nmos::experimental::resources_snapshots
+        mutable nmos::experimental::resources_snapshots registry_resources_snapshots;
+
         // Global configuration resource for IS-09 System API
         nmos::resource system_global_resource;
     };
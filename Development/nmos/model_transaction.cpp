@@ -0,0 +1,58 @@
+#include "nmos/model_transaction.h"
+
+#include <stdexcept>
+
+namespace nmos
+{
+    namespace experimental
+    {
+        node_model_transaction::node_model_transaction(nmos::node_model& model)
+            : model(model)
+            , owned_lock(model.mutex)
+            , lock(owned_lock)
+            , changes(0)
+        {
+        }
+
+        node_model_transaction::node_model_transaction(nmos::node_model& model, nmos::write_lock& lock)
+            : model(model)
+            , lock(lock)
+            , changes(0)
+        {
+            if (!lock.owns_lock() || lock.mutex() != &model.mutex) throw std::logic_error("model mutex must be locked for write");
+        }
+
+        node_model_transaction::~node_model_transaction()
+        {
+            if (lock.owns_lock()) commit();
+        }
+
+        bool node_model_transaction::insert(nmos::resources& resources, nmos::resource&& resource, bool join_sub_resources)
+        {
+            const bool success = insert_resource(resources, std::move(resource), join_sub_resources).second;
+            if (success) ++changes;
+            return success;
+        }
+
+        bool node_model_transaction::modify(nmos::resources& resources, const nmos::id& id, std::function<void(nmos::resource&)> modifier)
+        {
+            const bool success = modify_resource(resources, id, std::move(modifier));
+            if (success) ++changes;
+            return success;
+        }
+
+        bool node_model_transaction::erase(nmos::resources& resources, const nmos::id& id, bool forget_now)
+        {
+            const bool success = 0 != erase_resource(resources, id, forget_now);
+            if (success) ++changes;
+            return success;
+        }
+
+        void node_model_transaction::commit()
+        {
+            if (0 == changes) return;
+            changes = 0;
+            model.notify();
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef NMOS_MODEL_TRANSACTION_H
+#define NMOS_MODEL_TRANSACTION_H
+
+#include <functional>
+#include "nmos/model.h"
+
+// This is an experimental extension to apply many changes to the node model resources with a single notification
+namespace nmos
+{
+    namespace experimental
+    {
+        // a batch of inserts, modifications and erasures of resources in the node model, all made while holding the write lock,
+        // after which the threads waiting on the model condition, e.g. node behaviour, connection activation and the Events WebSocket API,
+        // are notified just once, when the transaction is committed (or destroyed)
+        // since each change is made immediately, later changes in the transaction can see earlier ones, and the resource events
+        // for all of them are already queued for each subscription when those threads wake up, so are handled in a single pass
+        // (rather than one wake-up, and e.g. one Registration API request, per change)
+        class node_model_transaction
+        {
+        public:
+            // lock the model mutex, for write, for the lifetime of the transaction
+            explicit node_model_transaction(nmos::node_model& model);
+            // use the caller's write lock, which must already be locked, and must not be unlocked until the transaction is committed
+            node_model_transaction(nmos::node_model& model, nmos::write_lock& lock);
+            ~node_model_transaction();
+
+            node_model_transaction(const node_model_transaction&) = delete;
+            node_model_transaction& operator=(const node_model_transaction&) = delete;
+
+            // resources must be one of the node model's node_resources, connection_resources or events_resources
+            // each returns whether the change was successful, as per nmos::insert_resource, nmos::modify_resource and nmos::erase_resource
+            bool insert(nmos::resources& resources, nmos::resource&& resource, bool join_sub_resources = false);
+            bool modify(nmos::resources& resources, const nmos::id& id, std::function<void(nmos::resource&)> modifier);
+            bool erase(nmos::resources& resources, const nmos::id& id, bool forget_now = true);
+
+            // the number of successful changes since the transaction was begun or last committed
+            std::size_t size() const { return changes; }
+
+            // notify the model condition, once, if any changes have been made
+            // the transaction may continue to be used afterwards, with the lock still held
+            void commit();
+
+        private:
+            nmos::node_model& model;
+            nmos::write_lock owned_lock;
+            nmos::write_lock& lock;
+            std::size_t changes;
+        };
+    }
+}
+
+#endif
@@ -1,17 +1,199 @@
 #ifndef NMOS_MUTEX_H
 #define NMOS_MUTEX_H
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
 #include "bst/shared_mutex.h"
+#include "nmos/metrics.h" // for nmos::experimental::duration_histogram
 
 namespace nmos
 {
-    typedef bst::shared_mutex mutex;
+    namespace experimental
+    {
+        // Lock statistics for an instrumented_mutex
+
+        enum lock_kind { shared_lock_kind, upgrade_lock_kind, exclusive_lock_kind, lock_kind_count };
+
+        struct lock_statistics
+        {
+            // time spent waiting to acquire ownership
+            duration_histogram wait;
+            // time for which ownership was held
+            duration_histogram hold;
+        };
+
+        // statistics are recorded per category (see mutex_category_guard) and kind of ownership
+        typedef std::map<std::string, std::array<lock_statistics, lock_kind_count>> mutex_statistics;
+
+        namespace details
+        {
+            // the category of the current thread for the purposes of lock statistics
+            inline std::string& mutex_category()
+            {
+                static thread_local std::string category;
+                return category;
+            }
+
+            // the ownership of instrumented mutexes held by the current thread, and when it was acquired
+            struct held_mutex
+            {
+                const void* mutex;
+                lock_kind kind;
+                std::chrono::steady_clock::time_point acquired;
+            };
+
+            inline std::vector<held_mutex>& held_mutexes()
+            {
+                static thread_local std::vector<held_mutex> held;
+                return held;
+            }
+        }
+
+        // identify the category, e.g. the nmos::category of a thread of execution, to which the current thread's lock statistics are attributed
+        // acquisitions by other threads, e.g. those handling API requests, are attributed to the empty category
+        class mutex_category_guard
+        {
+        public:
+            explicit mutex_category_guard(const std::string& category) : previous(details::mutex_category()) { details::mutex_category() = category; }
+            ~mutex_category_guard() { details::mutex_category() = previous; }
+            mutex_category_guard(const mutex_category_guard&) = delete;
+            mutex_category_guard& operator=(const mutex_category_guard&) = delete;
+        private:
+            std::string previous;
+        };
+
+        // a shared (and, if supported by the underlying mutex, upgradeable) mutex which can optionally record acquire-wait
+        // and hold-duration histograms, in order to measure contention between threads
+        // when statistics are disabled, the overhead is a relaxed atomic load per operation, and a search of the current thread's
+        // (usually empty) held mutexes on release
+        template <typename SharedMutex>
+        class instrumented_mutex
+        {
+        public:
+            instrumented_mutex() : enabled(false) {}
+            instrumented_mutex(const instrumented_mutex&) = delete;
+            instrumented_mutex& operator=(const instrumented_mutex&) = delete;
+
+            // exclusive ownership
+            void lock() { acquire(exclusive_lock_kind, [this] { m.lock(); }); }
+            bool try_lock() { return try_acquire(exclusive_lock_kind, m.try_lock()); }
+            void unlock() { release(exclusive_lock_kind); m.unlock(); }
+
+            // shared ownership
+            void lock_shared() { acquire(shared_lock_kind, [this] { m.lock_shared(); }); }
+            bool try_lock_shared() { return try_acquire(shared_lock_kind, m.try_lock_shared()); }
+            void unlock_shared() { release(shared_lock_kind); m.unlock_shared(); }
+
+            // upgrade ownership
+            void lock_upgrade() { acquire(upgrade_lock_kind, [this] { m.lock_upgrade(); }); }
+            bool try_lock_upgrade() { return try_acquire(upgrade_lock_kind, m.try_lock_upgrade()); }
+            void unlock_upgrade() { release(upgrade_lock_kind); m.unlock_upgrade(); }
+            void unlock_upgrade_and_lock() { release(upgrade_lock_kind); acquire(exclusive_lock_kind, [this] { m.unlock_upgrade_and_lock(); }); }
+            void unlock_and_lock_upgrade() { release(exclusive_lock_kind); acquire(upgrade_lock_kind, [this] { m.unlock_and_lock_upgrade(); }); }
+
+            // statistics are disabled by default
+            void enable_statistics(bool enable) { enabled = enable; }
+            bool statistics_enabled() const { return enabled; }
+
+            mutex_statistics statistics() const
+            {
+                std::lock_guard<std::mutex> lock(statistics_mutex);
+                return statistics_;
+            }
+
+            void reset_statistics()
+            {
+                std::lock_guard<std::mutex> lock(statistics_mutex);
+                statistics_.clear();
+            }
+
+        private:
+            template <typename Lock>
+            void acquire(lock_kind kind, Lock lock)
+            {
+                if (!enabled.load(std::memory_order_relaxed)) return lock();
+
+                const auto start = std::chrono::steady_clock::now();
+                lock();
+                const auto acquired = std::chrono::steady_clock::now();
+
+                details::held_mutexes().push_back({ this, kind, acquired });
+                record(kind, &lock_statistics::wait, acquired - start);
+            }
+
+            bool try_acquire(lock_kind kind, bool locked)
+            {
+                if (!locked || !enabled.load(std::memory_order_relaxed)) return locked;
+
+                const auto acquired = std::chrono::steady_clock::now();
+
+                details::held_mutexes().push_back({ this, kind, acquired });
+                record(kind, &lock_statistics::wait, std::chrono::nanoseconds::zero());
+                return true;
+            }
+
+            void release(lock_kind kind)
+            {
+                // ownership acquired before statistics were enabled isn't found, so the hold duration isn't recorded
+                // and ownership acquired while statistics were enabled must be found even if they have since been disabled,
+                // otherwise the entry would be left behind, and matched by a later release instead
+                auto& held = details::held_mutexes();
+                if (held.empty()) return;
+                for (auto it = held.rbegin(); held.rend() != it; ++it)
+                {
+                    if (this == it->mutex && kind == it->kind)
+                    {
+                        const auto acquired = it->acquired;
+                        held.erase(std::next(it).base());
+                        if (enabled.load(std::memory_order_relaxed)) record(kind, &lock_statistics::hold, std::chrono::steady_clock::now() - acquired);
+                        break;
+                    }
+                }
+            }
+
+            void record(lock_kind kind, duration_histogram lock_statistics::*histogram, std::chrono::steady_clock::duration duration)
+            {
+                std::lock_guard<std::mutex> lock(statistics_mutex);
+                (statistics_[details::mutex_category()][kind].*histogram).record(duration);
+            }
+
+            SharedMutex m;
+            std::atomic<bool> enabled;
+            mutable std::mutex statistics_mutex;
+            mutex_statistics statistics_;
+        };
+    }
+
+    typedef experimental::instrumented_mutex<bst::shared_mutex> mutex;
 
     typedef bst::shared_lock<mutex> read_lock;
     typedef std::unique_lock<mutex> write_lock;
 
-    // locking strategy tag structs must be usable for both read_lock and write_lock
+    // an upgrade lock has shared ownership with respect to read locks, but exclusive ownership with respect to other upgrade
+    // locks and write locks, so that it can be atomically upgraded to a write lock, e.g. by constructing an upgrade_to_write_lock,
+    // only when the protected data actually needs to be modified, without another thread being able to preempt in between
+#ifdef BST_SHARED_MUTEX_BOOST
+    typedef bst::upgrade_lock<mutex> upgrade_lock;
+    typedef bst::upgrade_to_unique_lock<mutex> upgrade_to_write_lock;
+#else
+    // without upgrade ownership, the closest equivalent is exclusive ownership from the outset
+    typedef std::unique_lock<mutex> upgrade_lock;
+    struct upgrade_to_write_lock
+    {
+        explicit upgrade_to_write_lock(upgrade_lock&) {}
+        upgrade_to_write_lock(const upgrade_to_write_lock&) = delete;
+        upgrade_to_write_lock& operator=(const upgrade_to_write_lock&) = delete;
+    };
+#endif
+
+    // locking strategy tag structs must be usable for read_lock, upgrade_lock and write_lock
 #ifndef BST_SHARED_MUTEX_BOOST
     typedef std::adopt_lock_t adopt_lock_t;
     typedef std::defer_lock_t defer_lock_t;
@@ -38,6 +220,13 @@ namespace nmos
         return func();
     }
 
+    template <typename Func>
+    auto with_upgrade_lock(nmos::mutex& mutex, Func&& func) -> decltype(func())
+    {
+        nmos::upgrade_lock lock(mutex);
+        return func();
+    }
+
     template <typename Func>
     auto with_write_lock(nmos::mutex& mutex, Func&& func) -> decltype(func())
     {
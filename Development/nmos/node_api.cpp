@@ -86,7 +86,19 @@ namespace nmos
                 if (nmos::is_permitted_downgrade(*resource, version))
                 {
                     slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Returning self resource: " << resource->id;
-                    set_reply(res, status_codes::OK, nmos::downgrade(*resource, version));
+
+                    // experimental extension, to support conditional requests
+                    const auto etag = nmos::experimental::make_etag(resource->updated);
+                    res.headers().add(web::http::header_names::etag, etag);
+
+                    if (nmos::experimental::is_not_modified(req, etag))
+                    {
+                        set_reply(res, status_codes::NotModified);
+                    }
+                    else
+                    {
+                        nmos::experimental::set_cached_reply(req, res, status_codes::OK, *resource, nmos::serialize_downgrade(*resource, version), nmos::experimental::fields::http_compression_threshold(model.settings));
+                    }
                 }
                 else
                 {
@@ -116,13 +128,34 @@ namespace nmos
 
             const auto match = [&](const nmos::resources::value_type& resource) { return resource.type == nmos::type_from_resourceType(resourceType) && nmos::is_permitted_downgrade(resource, version); };
 
-            size_t count = 0;
+            // collect the matching resources first, in order to determine the entity-tag before doing any downgrade or serialization
+            std::vector<const nmos::resource*> matching;
+            nmos::tai most_recent_update;
+            for (const auto& resource : resources)
+            {
+                if (!match(resource)) continue;
+                matching.push_back(&resource);
+                if (most_recent_update < resource.updated) most_recent_update = resource.updated;
+            }
+            const size_t count = matching.size();
 
-            set_reply(res, status_codes::OK,
-                web::json::serialize_if(resources,
-                    match,
-                    [&count, &version](const nmos::resources::value_type& resource) { ++count; return nmos::downgrade(resource, version); }),
-                web::http::details::mime_types::application_json);
+            // experimental extension, to support conditional requests
+            // (the Node API doesn't support paging, so this is like a page of all the matching resources)
+            const auto etag = nmos::experimental::make_etag(nmos::tai{}, most_recent_update, count);
+            res.headers().add(web::http::header_names::etag, etag);
+
+            if (nmos::experimental::is_not_modified(req, etag))
+            {
+                set_reply(res, status_codes::NotModified);
+            }
+            else
+            {
+                set_reply(res, status_codes::OK,
+                    nmos::details::serialize_array_if(matching,
+                        [](const nmos::resource*) { return true; },
+                        [&version](const nmos::resource* resource) { return nmos::serialize_downgrade(*resource, version); }),
+                    web::http::details::mime_types::application_json);
+            }
 
             slog::log<slog::severities::info>(gate, SLOG_FLF) << "Returning " << count << " matching " << resourceType;
 
@@ -145,7 +178,19 @@ namespace nmos
                 if (nmos::is_permitted_downgrade(*resource, version))
                 {
                     slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Returning resource: " << resourceId;
-                    set_reply(res, status_codes::OK, nmos::downgrade(*resource, version));
+
+                    // experimental extension, to support conditional requests
+                    const auto etag = nmos::experimental::make_etag(resource->updated);
+                    res.headers().add(web::http::header_names::etag, etag);
+
+                    if (nmos::experimental::is_not_modified(req, etag))
+                    {
+                        set_reply(res, status_codes::NotModified);
+                    }
+                    else
+                    {
+                        nmos::experimental::set_cached_reply(req, res, status_codes::OK, *resource, nmos::serialize_downgrade(*resource, version), nmos::experimental::fields::http_compression_threshold(model.settings));
+                    }
                 }
                 else
                 {
@@ -41,6 +41,7 @@ namespace nmos
     void node_behaviour_thread(nmos::model& model, slog::base_gate& gate_)
     {
         nmos::details::omanip_gate gate(gate_, nmos::stash_category(nmos::categories::node_behaviour));
+        nmos::experimental::mutex_category_guard mutex_category(nmos::categories::node_behaviour);
 
         // The possible states of node behaviour represent the two primary modes (registered operation and peer-to-peer operation)
         // and a few hopefully ephemeral states as the node works through the "Standard Registration Sequences".
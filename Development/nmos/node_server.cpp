@@ -5,6 +5,7 @@
 #include "nmos/events_api.h"
 #include "nmos/events_ws_api.h"
 #include "nmos/logging_api.h"
+#include "nmos/metrics_api.h"
 #include "nmos/node_api.h"
 #include "nmos/node_behaviour.h"
 #include "nmos/server.h"
@@ -35,6 +36,9 @@ namespace nmos
             const host_port settings_address(nmos::experimental::fields::settings_address(node_model.settings), nmos::experimental::fields::settings_port(node_model.settings));
             node_server.api_routers[settings_address].mount({}, nmos::experimental::make_settings_api(node_model, log_model, gate));
 
+            // the Settings API also exposes lock statistics for the model mutex, if enabled
+            node_model.mutex.enable_statistics(nmos::experimental::fields::mutex_statistics(node_model.settings));
+
             // Configure the Logging API
 
             const host_port logging_address(nmos::experimental::fields::logging_address(node_model.settings), nmos::experimental::fields::logging_port(node_model.settings));
@@ -55,17 +59,25 @@ namespace nmos
             auto& events_ws_api = node_server.ws_handlers[{ {}, nmos::fields::events_ws_port(node_model.settings) }];
             events_ws_api.first = nmos::make_events_ws_api(node_model, events_ws_api.second, gate);
 
+            // Configure the Metrics API
+
+            const host_port metrics_address(nmos::experimental::fields::metrics_address(node_model.settings), nmos::experimental::fields::metrics_port(node_model.settings));
+            node_server.api_routers[metrics_address].mount({}, nmos::experimental::make_metrics_api(node_model, events_ws_api.second, log_model, gate));
+
             // Set up the listeners for each HTTP API port
 
             auto http_config = nmos::make_http_listener_config(node_model.settings);
 
             for (auto& api_router : node_server.api_routers)
             {
+                // record per-route request counts and latencies, exposed via the Metrics API
+                api_router.second.set_statistics_handler(nmos::experimental::make_route_statistics_handler(node_model.metrics.routes));
+
                 // default empty string means the wildcard address
                 const auto& host = !api_router.first.first.empty() ? api_router.first.first : web::http::experimental::listener::host_wildcard;
                 // map the configured client port to the server port on which to listen
                 // hmm, this should probably also take account of the address
-                node_server.http_listeners.push_back(nmos::make_api_listener(server_secure, host, nmos::experimental::server_port(api_router.first.second, node_model.settings), api_router.second, http_config, gate));
+                node_server.http_listeners.push_back(nmos::make_api_listener(server_secure, host, nmos::experimental::server_port(api_router.first.second, node_model.settings), api_router.second, http_config, nmos::experimental::fields::http_compression_threshold(node_model.settings), gate));
             }
 
             // Set up the handlers for each WebSocket API port
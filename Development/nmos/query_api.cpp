@@ -1,5 +1,9 @@
 #include "nmos/query_api.h"
 
+#include <list>
+#include <map>
+#include <mutex>
+#include <unordered_map>
 #include <boost/range/adaptor/transformed.hpp>
 #include "cpprest/json_validator.h"
 #include "cpprest/json_visit.h"
@@ -311,6 +315,91 @@ namespace nmos
         }
     }
 
+    namespace details
+    {
+        // a Query API result page, i.e. the serialized resources and the updated paging parameters,
+        // and the compressed forms of the response body, which are built when first requested
+        struct query_result
+        {
+            query_result(const resource_paging& paging, std::vector<std::shared_ptr<const utility::string_t>> elements)
+                : paging(paging)
+                , elements(std::move(elements))
+            {}
+
+            resource_paging paging;
+            std::vector<std::shared_ptr<const utility::string_t>> elements;
+            mutable nmos::experimental::compressed_bodies compressed;
+        };
+
+        // bounded cache of Query API result pages, evicting the least recently used
+        // since the key includes the most recent update to the registry, any update implicitly causes subsequent requests to miss
+        // and the stale entries are gradually evicted
+        class query_cache
+        {
+        public:
+            explicit query_cache(size_t capacity) : capacity(capacity) {}
+
+            std::shared_ptr<const query_result> find(const utility::string_t& key)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                auto found = index.find(key);
+                if (index.end() == found) return{};
+                // move the entry to the front, as the most recently used
+                entries.splice(entries.begin(), entries, found->second);
+                return found->second->second;
+            }
+
+            void insert(const utility::string_t& key, std::shared_ptr<const query_result> result)
+            {
+                if (0 == capacity) return;
+                std::lock_guard<std::mutex> lock(mutex);
+                auto found = index.find(key);
+                if (index.end() != found)
+                {
+                    found->second->second = std::move(result);
+                    entries.splice(entries.begin(), entries, found->second);
+                    return;
+                }
+                entries.emplace_front(key, std::move(result));
+                index[key] = entries.begin();
+                while (entries.size() > capacity)
+                {
+                    index.erase(entries.back().first);
+                    entries.pop_back();
+                }
+            }
+
+        private:
+            typedef std::list<std::pair<utility::string_t, std::shared_ptr<const query_result>>> entries_type;
+
+            const size_t capacity;
+            std::mutex mutex;
+            entries_type entries;
+            std::unordered_map<utility::string_t, entries_type::iterator> index;
+        };
+
+        // make the cache key from everything which determines the result page, i.e. the API version, resource path,
+        // query parameters (in canonical order), including the paging cursor, the paging settings and the generation of the resources
+        // (rather than the most recent update, which isn't changed when resources expire)
+        utility::string_t make_query_cache_key(const nmos::api_version& version, const utility::string_t& resourceType, const web::json::value& flat_query_params, std::uint64_t generation, const nmos::settings& settings)
+        {
+            std::map<utility::string_t, utility::string_t> canonical_query_params;
+            for (const auto& field : flat_query_params.as_object())
+            {
+                canonical_query_params[field.first] = field.second.serialize();
+            }
+
+            utility::ostringstream_t key;
+            key << make_api_version(version) << U('/') << resourceType << U('?');
+            for (const auto& param : canonical_query_params)
+            {
+                key << param.first << U('=') << param.second << U('&');
+            }
+            key << U('#') << nmos::fields::query_paging_default(settings) << U(',') << nmos::fields::query_paging_limit(settings) << U(',') << generation;
+            return key.str();
+        }
+    }
+
     inline web::http::experimental::listener::api_router make_unmounted_query_api(nmos::registry_model& model, slog::base_gate& gate_)
     {
         using namespace web::http::experimental::listener::api_router_using_declarations;
@@ -321,17 +410,30 @@ namespace nmos
         const auto versions = with_read_lock(model.mutex, [&model] { return nmos::is04_versions::from_settings(model.settings); });
         query_api.support(U(".*"), details::make_api_version_handler(versions, gate_));
 
+        // experimental extension, to cache Query API result pages
+        const auto cache_size = with_read_lock(model.mutex, [&model] { return nmos::experimental::fields::query_cache_size(model.settings); });
+        auto cache = std::make_shared<details::query_cache>(0 < cache_size ? (size_t)cache_size : 0);
+
         query_api.support(U("/?"), methods::GET, [](http_request req, http_response res, const string_t&, const route_parameters&)
         {
             set_reply(res, status_codes::OK, nmos::make_sub_routes_body({ U("nodes/"), U("devices/"), U("sources/"), U("flows/"), U("senders/"), U("receivers/"), U("subscriptions/") }, req, res));
             return pplx::task_from_result(true);
         });
 
-        query_api.support(U("/") + nmos::patterns::queryType.pattern + U("/?"), methods::GET, [&model, &gate_](http_request req, http_response res, const string_t&, const route_parameters& parameters)
+        query_api.support(U("/") + nmos::patterns::queryType.pattern + U("/?"), methods::GET, [&model, cache, &gate_](http_request req, http_response res, const string_t&, const route_parameters& parameters)
         {
             nmos::api_gate gate(gate_, req, parameters);
-            auto lock = model.read_lock();
-            auto& resources = model.registry_resources;
+            nmos::experimental::duration_recorder duration(model.metrics.query_api_duration);
+            // experimental extension, to match, downgrade and serialize resources without holding the model mutex, so that Query API requests
+            // do not delay registrations and heartbeats, by using a consistent snapshot of the registry resources (and a copy of the settings)
+            std::shared_ptr<const nmos::resources> snapshot;
+            nmos::settings settings;
+            with_read_lock(model.mutex, [&]
+            {
+                snapshot = model.registry_resources_snapshots.get(model.registry_resources, std::chrono::milliseconds(nmos::experimental::fields::query_snapshot_interval_ms(model.settings)));
+                settings = model.settings;
+            });
+            auto& resources = *snapshot;
 
             const nmos::api_version version = nmos::parse_api_version(parameters.at(nmos::patterns::version.name));
             const string_t resourceType = parameters.at(nmos::patterns::queryType.name);
@@ -340,16 +442,50 @@ namespace nmos
 
             const auto flat_query_params = details::parse_query_parameters(req.request_uri().query());
 
+            // experimental extension, to reply from the cache when an identical request has been handled since the registry was last updated
+            // (the human-readable HTML rendering is not cached)
+            const bool html = experimental::details::is_html_response_preferred(req, web::http::details::mime_types::application_json);
+            const auto cache_key = details::make_query_cache_key(version, resourceType, flat_query_params, resources.generation, settings);
+            if (!html)
+            {
+                if (auto cached = cache->find(cache_key))
+                {
+                    ++model.metrics.query_cache_hits;
+
+                    const auto count = cached->elements.size();
+
+                    const auto etag = experimental::make_etag(cached->paging.since, cached->paging.until, count, resources.generation);
+                    res.headers().add(web::http::header_names::etag, etag);
+
+                    if (experimental::is_not_modified(req, etag))
+                    {
+                        set_reply(res, status_codes::NotModified);
+                    }
+                    else
+                    {
+                        experimental::set_cached_reply_json_array(req, res, status_codes::OK, cached->elements, cached->compressed, nmos::experimental::fields::http_compression_threshold(settings));
+                    }
+
+                    slog::log<slog::severities::info>(gate, SLOG_FLF) << "Returning " << count << " matching " << resourceType << " from cache";
+
+                    details::add_paging_headers(res.headers(), cached->paging, details::make_query_uri_with_no_paging(req, settings));
+
+                    return pplx::task_from_result(true);
+                }
+                ++model.metrics.query_cache_misses;
+            }
+
             // Configure the query predicate
 
-            const resource_query match(version, U('/') + resourceType, flat_query_params);
+            resource_query match(version, U('/') + resourceType, flat_query_params);
+            match.resolve_ancestry(resources);
 
             slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Querying " << resourceType;
 
             // Configure the paging parameters
 
             // Limit queries to the current resources (although tai_now() would also be an option?) and use the paging limit (default and max) from the setings
-            resource_paging paging(flat_query_params, most_recent_update(resources), (size_t)nmos::fields::query_paging_default(model.settings), (size_t)nmos::fields::query_paging_limit(model.settings));
+            resource_paging paging(flat_query_params, most_recent_update(resources), (size_t)nmos::fields::query_paging_default(settings), (size_t)nmos::fields::query_paging_limit(settings));
 
             if (paging.valid())
             {
@@ -357,27 +493,49 @@ namespace nmos
                 struct default_constructible_resource_query_wrapper { const resource_query* impl; bool operator()(const nmos::resource& r) const { return (*impl)(r); } };
                 auto page = paging.page(resources, default_constructible_resource_query_wrapper{ &match }); // std::cref(match) is OK from Boost.Range 1.56.0
 
-                size_t count = 0;
+                // collect the matching resources first, in order to determine the entity-tag before doing any downgrade or serialization
+                std::vector<const nmos::resource*> matching;
+                for (const auto& resource : page)
+                {
+                    matching.push_back(&resource);
+                }
+                const size_t count = matching.size();
 
+                // experimental extension, to support conditional requests
+                const auto etag = experimental::make_etag(paging.since, paging.until, count, resources.generation);
+                res.headers().add(web::http::header_names::etag, etag);
+
+                if (experimental::is_not_modified(req, etag))
+                {
+                    set_reply(res, status_codes::NotModified);
+                }
                 // experimental extension, to support human-readable HTML rendering of NMOS responses
-                if (experimental::details::is_html_response_preferred(req, web::http::details::mime_types::application_json))
+                else if (html)
                 {
                     set_reply(res, status_codes::OK,
-                        web::json::serialize(page,
-                            [&count, &match, &version, &resourceType](const nmos::resource& resource) { ++count; return experimental::details::make_query_api_html_response_body(version, nmos::type_from_resourceType(resourceType), match.downgrade(resource)); }),
+                        web::json::serialize(matching,
+                            [&match, &version, &resourceType](const nmos::resource* resource) { return experimental::details::make_query_api_html_response_body(version, nmos::type_from_resourceType(resourceType), match.downgrade(*resource)); }),
                         web::http::details::mime_types::application_json);
                 }
                 else
                 {
-                    set_reply(res, status_codes::OK,
-                        web::json::serialize(page,
-                            [&count, &match](const nmos::resources::value_type& resource) { ++count; return match.downgrade(resource); }),
-                        web::http::details::mime_types::application_json);
+                    // assemble the response body from the serialized resources cached since each was last updated
+                    // large pages are streamed, so the elements are collected rather than concatenated
+                    std::vector<std::shared_ptr<const utility::string_t>> elements;
+                    elements.reserve(count);
+                    for (const auto resource : matching)
+                    {
+                        elements.push_back(match.serialize_downgrade(*resource));
+                    }
+                    auto result = std::make_shared<const details::query_result>(paging, std::move(elements));
+                    experimental::set_cached_reply_json_array(req, res, status_codes::OK, result->elements, result->compressed, nmos::experimental::fields::http_compression_threshold(settings));
+
+                    cache->insert(cache_key, result);
                 }
 
                 slog::log<slog::severities::info>(gate, SLOG_FLF) << "Returning " << count << " matching " << resourceType;
 
-                details::add_paging_headers(res.headers(), paging, details::make_query_uri_with_no_paging(req, model.settings));
+                details::add_paging_headers(res.headers(), paging, details::make_query_uri_with_no_paging(req, settings));
             }
             else
             {
@@ -390,8 +548,17 @@ namespace nmos
         query_api.support(U("/") + nmos::patterns::queryType.pattern + U("/") + nmos::patterns::resourceId.pattern + U("/?"), methods::GET, [&model, &gate_](http_request req, http_response res, const string_t&, const route_parameters& parameters)
         {
             nmos::api_gate gate(gate_, req, parameters);
-            auto lock = model.read_lock();
-            auto& resources = model.registry_resources;
+            nmos::experimental::duration_recorder duration(model.metrics.query_api_duration);
+            // experimental extension, to match, downgrade and serialize resources without holding the model mutex, so that Query API requests
+            // do not delay registrations and heartbeats, by using a consistent snapshot of the registry resources (and a copy of the settings)
+            std::shared_ptr<const nmos::resources> snapshot;
+            nmos::settings settings;
+            with_read_lock(model.mutex, [&]
+            {
+                snapshot = model.registry_resources_snapshots.get(model.registry_resources, std::chrono::milliseconds(nmos::experimental::fields::query_snapshot_interval_ms(model.settings)));
+                settings = model.settings;
+            });
+            auto& resources = *snapshot;
 
             const nmos::api_version version = nmos::parse_api_version(parameters.at(nmos::patterns::version.name));
             const string_t resourceType = parameters.at(nmos::patterns::queryType.name);
@@ -411,14 +578,22 @@ namespace nmos
                 {
                     slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Returning resource: " << resourceId;
 
+                    // experimental extension, to support conditional requests
+                    const auto etag = experimental::make_etag(resource->updated);
+                    res.headers().add(web::http::header_names::etag, etag);
+
+                    if (experimental::is_not_modified(req, etag))
+                    {
+                        set_reply(res, status_codes::NotModified);
+                    }
                     // experimental extension, to support human-readable HTML rendering of NMOS responses
-                    if (experimental::details::is_html_response_preferred(req, web::http::details::mime_types::application_json))
+                    else if (experimental::details::is_html_response_preferred(req, web::http::details::mime_types::application_json))
                     {
                         set_reply(res, status_codes::OK, experimental::details::make_query_api_html_response_body(version, nmos::type_from_resourceType(resourceType), match.downgrade(*resource)));
                     }
                     else
                     {
-                        set_reply(res, status_codes::OK, match.downgrade(*resource));
+                        nmos::experimental::set_cached_reply(req, res, status_codes::OK, *resource, match.serialize_downgrade(*resource), nmos::experimental::fields::http_compression_threshold(settings));
                     }
 
                     // experimental extension, see also nmos::make_resource_events for equivalent WebSockets extension
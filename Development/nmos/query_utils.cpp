@@ -24,6 +24,57 @@ namespace nmos
                 | (match_flags.end() != match_flags.find(U("icase")) ? web::json::match_icase : web::json::match_default)
                 ;
         }
+
+        // parse a comma-separated list of '.'-separated key paths, e.g. "id,label,caps.media_types"
+        key_paths parse_fields(const utility::string_t& fields)
+        {
+            std::vector<utility::string_t> paths;
+            boost::algorithm::split(paths, fields, [](utility::char_t c){ return ',' == c; });
+
+            key_paths result;
+            for (const auto& path : paths)
+            {
+                if (path.empty()) continue;
+                std::vector<utility::string_t> keys;
+                boost::algorithm::split(keys, path, [](utility::char_t c){ return '.' == c; });
+                result.push_back(keys);
+            }
+            return result;
+        }
+
+        namespace details
+        {
+            void project(web::json::value& result, const web::json::value& value, std::vector<utility::string_t>::const_iterator first, std::vector<utility::string_t>::const_iterator last)
+            {
+                if (!value.is_object() || !value.has_field(*first)) return;
+                const auto& element = value.at(*first);
+                if (last == std::next(first))
+                {
+                    result[*first] = element;
+                }
+                else if (element.is_object())
+                {
+                    auto& sub_result = result[*first];
+                    project(sub_result, element, std::next(first), last);
+                    // don't leave an empty object behind when the rest of the key path is not present
+                    if (sub_result.is_null()) result.erase(*first);
+                }
+            }
+        }
+
+        // project the specified value down to the specified key paths, omitting any which are not present
+        web::json::value project(const web::json::value& value, const key_paths& fields)
+        {
+            if (value.is_null()) return value;
+
+            auto result = web::json::value::object();
+            for (const auto& keys : fields)
+            {
+                if (keys.empty()) continue;
+                details::project(result, value, keys.begin(), keys.end());
+            }
+            return result;
+        }
     }
 
     resource_query::resource_query(const nmos::api_version& version, const utility::string_t& resource_path, const web::json::value& flat_query_params)
@@ -33,6 +84,7 @@ namespace nmos
         , downgrade_version(version)
         , strip(true)
         , match_flags(web::json::match_default)
+        , ancestry_generations(0)
     {
         // extract the supported advanced query options
         if (basic_query.has_field(U("paging")))
@@ -64,9 +116,36 @@ namespace nmos
                 {
                     match_flags = experimental::parse_match_type(field.second.as_string());
                 }
-                // taking query.ancestry_id as an example, an error should be reported for unimplemented parameters
-                // "A 501 HTTP status code should be returned where an ancestry query is attempted against a Query API which does not implement it."
+                // extract the experimental field projection, to return only the specified key paths of each resource
+                else if (field.first == U("fields"))
+                {
+                    fields = experimental::parse_fields(field.second.as_string());
+                }
+                // extract the ancestry query parameters
                 // See https://github.com/AMWA-TV/nmos-discovery-registration/blob/v1.2/docs/2.5.%20APIs%20-%20Query%20Parameters.md#ancestry-queries-optional
+                else if (field.first == U("ancestry_id"))
+                {
+                    ancestry_id = field.second.as_string();
+                }
+                else if (field.first == U("ancestry_type"))
+                {
+                    ancestry_type = field.second.as_string();
+                    if (U("children") != ancestry_type && U("parents") != ancestry_type)
+                    {
+                        throw web::json::json_exception(U("query.ancestry_type must be \"children\" or \"parents\""));
+                    }
+                }
+                else if (field.first == U("ancestry_generations"))
+                {
+                    // query parameters are strings, unlike e.g. paging.limit, which is parsed by the Query API
+                    const auto generations = field.second.is_string() ? web::json::value::parse(field.second.as_string()) : field.second;
+                    if (!generations.is_integer() || 0 > generations.as_number().to_int64())
+                    {
+                        throw web::json::json_exception(U("query.ancestry_generations must be a non-negative integer"));
+                    }
+                    ancestry_generations = (size_t)generations.as_number().to_uint64();
+                }
+                // an error should be reported for unimplemented parameters
                 else
                 {
                     throw std::runtime_error("unimplemented parameter - query." + utility::us2s(field.first));
@@ -74,6 +153,17 @@ namespace nmos
             }
             basic_query.erase(U("query"));
         }
+
+        if (!ancestry_id.empty() && ancestry_type.empty())
+        {
+            throw web::json::json_exception(U("query.ancestry_type is required for an ancestry query"));
+        }
+    }
+
+    void resource_query::resolve_ancestry(const nmos::resources& resources)
+    {
+        if (ancestry_id.empty()) return;
+        ancestry = nmos::get_ancestry(resources, ancestry_id, ancestry_type, ancestry_generations);
     }
 
     resource_paging::resource_paging(const web::json::value& flat_query_params, const nmos::tai& max_until, size_t default_limit, size_t max_limit)
@@ -214,10 +304,22 @@ namespace nmos
             && (resource_path.empty() || resource_path == U('/') + nmos::resourceType_from_type(resource_type))
             && nmos::is_permitted_downgrade(resource_version, resource_downgrade_version, resource_type, version, downgrade_version)
             && web::json::match_query(resource_data, basic_query, match_flags)
-            && match_rql(resource_data, rql_query);
+            && match_rql(resource_data, rql_query)
+            && (ancestry_id.empty() || ancestry.end() != ancestry.find(nmos::fields::id(resource_data)));
     }
 
     web::json::value resource_query::downgrade(const nmos::api_version& resource_version, const nmos::api_version& resource_downgrade_version, const nmos::type& resource_type, const web::json::value& resource_data) const
+    {
+        // when requested, return only the specified fields
+        if (!fields.empty())
+        {
+            return experimental::project(downgrade_unprojected(resource_version, resource_downgrade_version, resource_type, resource_data), fields);
+        }
+
+        return downgrade_unprojected(resource_version, resource_downgrade_version, resource_type, resource_data);
+    }
+
+    web::json::value resource_query::downgrade_unprojected(const nmos::api_version& resource_version, const nmos::api_version& resource_downgrade_version, const nmos::type& resource_type, const web::json::value& resource_data) const
     {
         // when requested, return the resource not stripped
         if (!strip && resource_version.major == version.major && resource_version.minor > version.minor) return resource_data;
@@ -225,10 +327,43 @@ namespace nmos
         return nmos::downgrade(resource_version, resource_downgrade_version, resource_type, resource_data, version, downgrade_version);
     }
 
+    std::shared_ptr<const utility::string_t> resource_query::serialize_downgrade(const nmos::resource& resource) const
+    {
+        // projected resources are not cached, since the fields may differ for every query, but are likely to be much smaller anyway
+        if (!fields.empty()) return std::make_shared<const utility::string_t>(downgrade(resource).serialize());
+
+        // when requested, return the resource not stripped
+        if (!strip && resource.version.major == version.major && resource.version.minor > version.minor) return nmos::details::serialize(resource);
+
+        return nmos::serialize_downgrade(resource, version, downgrade_version);
+    }
+
     // Helpers for constructing /subscriptions websocket grains
 
     namespace details
     {
+        // resolve the ancestry query of the specified subscription, reusing the ancestry resolved for a previous resource event unless the ancestry graph has since changed
+        void resolve_subscription_ancestry(nmos::resources& resources, const nmos::id& subscription_id, resource_query& match)
+        {
+            if (match.ancestry_id.empty()) return;
+
+            if (resources.resolved_ancestries_generation != resources.ancestry_generation)
+            {
+                resources.resolved_ancestries.clear();
+                resources.resolved_ancestries_generation = resources.ancestry_generation;
+            }
+
+            auto resolved = resources.resolved_ancestries.find(subscription_id);
+            if (resources.resolved_ancestries.end() != resolved)
+            {
+                match.ancestry = resolved->second;
+                return;
+            }
+
+            match.resolve_ancestry(resources);
+            resources.resolved_ancestries.insert({ subscription_id, match.ancestry });
+        }
+
         bool is_queryable_resource(const nmos::type& type)
         {
             return type != types::subscription && type != types::grain;
@@ -313,7 +448,8 @@ namespace nmos
     // make the initial 'sync' resource events for a new grain, including all resources that match the specified version, resource path and flat query parameters
     web::json::value make_resource_events(const nmos::resources& resources, const nmos::api_version& version, const utility::string_t& resource_path, const web::json::value& params)
     {
-        const resource_query match(version, resource_path, params);
+        resource_query match(version, resource_path, params);
+        match.resolve_ancestry(resources);
 
         std::vector<web::json::value> events;
 
@@ -360,6 +496,12 @@ namespace nmos
 
         if (!details::is_queryable_resource(type)) return;
 
+        if (resources.resource_events_handler)
+        {
+            resources.resource_events_handler(resources, version, downgrade_version, type, pre, post);
+            return;
+        }
+
         auto& by_type = resources.get<tags::type>();
         const auto subscriptions = by_type.equal_range(details::has_data(nmos::types::subscription));
         for (auto it = subscriptions.first; subscriptions.second != it; ++it)
@@ -370,7 +512,8 @@ namespace nmos
             // check whether the resource_path matches the resource type and the query parameters match either the "pre" or "post" resource
 
             const auto resource_path = nmos::fields::resource_path(subscription.data);
-            const resource_query match(subscription.version, resource_path, nmos::fields::params(subscription.data));
+            resource_query match(subscription.version, resource_path, nmos::fields::params(subscription.data));
+            details::resolve_subscription_ancestry(resources, subscription.id, match);
 
             const bool pre_match = match(version, downgrade_version, type, pre);
             const bool post_match = match(version, downgrade_version, type, post);
@@ -12,6 +12,15 @@ namespace nmos
     namespace experimental
     {
         web::json::match_flag_type parse_match_type(const utility::string_t& match_type);
+
+        // key paths, e.g. "id", "caps.media_types", to which resources are projected
+        typedef std::vector<std::vector<utility::string_t>> key_paths;
+
+        // parse a comma-separated list of '.'-separated key paths, e.g. "id,label,caps.media_types"
+        key_paths parse_fields(const utility::string_t& fields);
+
+        // project the specified value down to the specified key paths, omitting any which are not present
+        web::json::value project(const web::json::value& value, const key_paths& fields);
     }
 
     // Predicate to match resources against a query
@@ -24,9 +33,12 @@ namespace nmos
 
         result_type operator()(argument_type resource) const { return (*this)(resource.version, resource.downgrade_version, resource.type, resource.data); }
         web::json::value downgrade(const nmos::resource& resource) const { return downgrade(resource.version, resource.downgrade_version, resource.type, resource.data); }
+        // serialized equivalent of downgrade, which is cached in the resource until it is next updated
+        std::shared_ptr<const utility::string_t> serialize_downgrade(const nmos::resource& resource) const;
 
         result_type operator()(const nmos::api_version& resource_version, const nmos::api_version& resource_downgrade_version, const nmos::type& resource_type, const web::json::value& resource_data) const;
         web::json::value downgrade(const nmos::api_version& resource_version, const nmos::api_version& resource_downgrade_version, const nmos::type& resource_type, const web::json::value& resource_data) const;
+        web::json::value downgrade_unprojected(const nmos::api_version& resource_version, const nmos::api_version& resource_downgrade_version, const nmos::type& resource_type, const web::json::value& resource_data) const;
 
         // the Query API version (since a registry being queried may contain resources of more than one version of IS-04 Discovery and Registration)
         nmos::api_version version;
@@ -48,6 +60,20 @@ namespace nmos
 
         // flags that affect the Basic Query (experimental)
         web::json::match_flag_type match_flags;
+
+        // key paths to which the returned resources are projected, or empty to return whole resources (experimental)
+        experimental::key_paths fields;
+
+        // the ancestry query parameters, i.e. the id of the source or flow from which to search, "children" or "parents",
+        // and the number of generations to search, or zero for all generations
+        // see https://github.com/AMWA-TV/nmos-discovery-registration/blob/v1.2/docs/2.5.%20APIs%20-%20Query%20Parameters.md#ancestry-queries-optional
+        nmos::id ancestry_id;
+        utility::string_t ancestry_type;
+        size_t ancestry_generations;
+
+        // the ids of the resources identified by the ancestry query, which must be resolved against the resources before matching
+        std::set<nmos::id> ancestry;
+        void resolve_ancestry(const nmos::resources& resources);
     };
 
     // Cursor-based paging parameters
@@ -109,6 +135,7 @@ namespace nmos
     web::json::value make_resource_events(const nmos::resources& resources, const nmos::api_version& version, const utility::string_t& resource_path, const web::json::value& params);
 
     // insert 'added', 'removed' or 'modified' resource events into all grains whose subscriptions match the specified version, type and "pre" or "post" values
+    // (or pass them to the resources' resource_events_handler, if specified)
     void insert_resource_events(nmos::resources& resources, const nmos::api_version& version, const nmos::api_version& downgrade_version, const nmos::type& type, const web::json::value& pre, const web::json::value& post);
 
     namespace fields
@@ -146,11 +146,13 @@ namespace nmos
     void send_query_ws_events_thread(web::websockets::experimental::listener::websocket_listener& listener, nmos::registry_model& model, nmos::websockets& websockets, slog::base_gate& gate_)
     {
         nmos::details::omanip_gate gate(gate_, nmos::stash_category(nmos::categories::send_query_ws_events));
+        nmos::experimental::mutex_category_guard mutex_category(nmos::categories::send_query_ws_events);
 
         using web::json::value;
 
-        // could start out as a shared/read lock, only upgraded to an exclusive/write lock when a grain in the resources is actually modified
-        auto lock = model.write_lock();
+        // start out as an upgrade lock, shared with readers, only upgraded to an exclusive/write lock when a grain in the resources is actually modified
+        // or a websocket is actually closed
+        auto lock = model.upgrade_lock();
         auto& condition = model.condition;
         auto& shutdown = model.shutdown;
         auto& resources = model.registry_resources;
@@ -182,6 +184,8 @@ namespace nmos
                 const auto grain = find_resource(resources, { websocket.first, nmos::types::grain });
                 if (resources.end() == grain)
                 {
+                    nmos::upgrade_to_write_lock upgrade(lock);
+
                     // theoretically blocking, but in fact not
                     listener.close(websocket.second, web::websockets::websocket_close_status::server_terminate, U("Deleted")).wait();
 
@@ -191,6 +195,8 @@ namespace nmos
                 const auto subscription = find_resource(resources, { nmos::fields::subscription_id(grain->data), nmos::types::subscription });
                 if (resources.end() == subscription)
                 {
+                    nmos::upgrade_to_write_lock upgrade(lock);
+
                     // a grain without a subscription shouldn't be possible, but let's be tidy
                     erase_resource(resources, grain->id);
 
@@ -246,26 +252,30 @@ namespace nmos
 
                 // prepare the message
 
-                resources.modify(grain, [&paging, &next_events, &origin_timestamp, &creation_timestamp](nmos::resource& grain)
                 {
-                    auto& message = nmos::fields::message(grain.data);
+                    nmos::upgrade_to_write_lock upgrade(lock);
 
-                    // postpone all the events after the specified limit
-                    auto& next_storage = web::json::storage_of(next_events.as_array());
-                    auto& message_storage = web::json::storage_of(nmos::fields::grain_data(message).as_array());
-                    if (paging.limit < message_storage.size())
+                    resources.modify(grain, [&paging, &next_events, &origin_timestamp, &creation_timestamp](nmos::resource& grain)
                     {
-                        const auto b = message_storage.begin() + paging.limit, e = message_storage.end();
-                        next_storage.assign(std::make_move_iterator(b), std::make_move_iterator(e));
-                        message_storage.erase(b, e);
-                        // hmm, feels like origin_timestamp should be adjusted in this case, but how?
-                    }
+                        auto& message = nmos::fields::message(grain.data);
 
-                    // set the timestamps
-                    message[nmos::fields::origin_timestamp] = origin_timestamp;
-                    message[nmos::fields::sync_timestamp] = origin_timestamp;
-                    message[nmos::fields::creation_timestamp] = creation_timestamp;
-                });
+                        // postpone all the events after the specified limit
+                        auto& next_storage = web::json::storage_of(next_events.as_array());
+                        auto& message_storage = web::json::storage_of(nmos::fields::grain_data(message).as_array());
+                        if (paging.limit < message_storage.size())
+                        {
+                            const auto b = message_storage.begin() + paging.limit, e = message_storage.end();
+                            next_storage.assign(std::make_move_iterator(b), std::make_move_iterator(e));
+                            message_storage.erase(b, e);
+                            // hmm, feels like origin_timestamp should be adjusted in this case, but how?
+                        }
+
+                        // set the timestamps
+                        message[nmos::fields::origin_timestamp] = origin_timestamp;
+                        message[nmos::fields::sync_timestamp] = origin_timestamp;
+                        message[nmos::fields::creation_timestamp] = creation_timestamp;
+                    });
+                }
 
                 slog::log<slog::severities::info>(gate, SLOG_FLF) << "Preparing to send " << nmos::fields::message_grain_data(grain->data).size() << " changes on websocket connection: " << grain->id;
 
@@ -309,19 +319,23 @@ namespace nmos
                 }
 
                 // reset the grain for next time
-                resources.modify(grain, [&next_events, &resources](nmos::resource& grain)
                 {
-                    using std::swap;
-                    swap(nmos::fields::message_grain_data(grain.data), next_events);
-                    next_events = value::array(); // unnecessary
-                    grain.updated = strictly_increasing_update(resources);
-                });
+                    nmos::upgrade_to_write_lock upgrade(lock);
+
+                    resources.modify(grain, [&next_events, &resources](nmos::resource& grain)
+                    {
+                        using std::swap;
+                        swap(nmos::fields::message_grain_data(grain.data), next_events);
+                        next_events = value::array(); // unnecessary
+                        grain.updated = strictly_increasing_update(resources);
+                    });
+                }
 
                 ++wit;
             }
 
             // send the messages without the lock on resources
-            details::reverse_lock_guard<nmos::write_lock> unlock{ lock };
+            details::reverse_lock_guard<nmos::upgrade_lock> unlock{ lock };
 
             if (!outgoing_messages.empty()) slog::log<slog::severities::info>(gate, SLOG_FLF) << "Sending " << outgoing_messages.size() << " websocket messages";
 
@@ -16,9 +16,10 @@ namespace nmos
     void erase_expired_resources_thread(nmos::registry_model& model, slog::base_gate& gate_)
     {
         nmos::details::omanip_gate gate(gate_, nmos::stash_category(nmos::categories::registration_expiry));
+        nmos::experimental::mutex_category_guard mutex_category(nmos::categories::registration_expiry);
 
-        // start out as a shared/read lock, only upgraded to an exclusive/write lock when an expired resource actually needs to be deleted from the resources
-        auto lock = model.read_lock();
+        // start out as an upgrade lock, shared with readers, only upgraded to an exclusive/write lock when an expired resource actually needs to be deleted from the resources
+        auto lock = model.upgrade_lock();
         auto& shutdown_condition = model.shutdown_condition;
         auto& shutdown = model.shutdown;
         auto& resources = model.registry_resources;
@@ -41,18 +42,15 @@ namespace nmos
 
             // otherwise, there's actually work to do...
 
-            details::reverse_lock_guard<nmos::read_lock> unlock(lock);
-            // note, without atomic upgrade, another thread may preempt hence the need to recalculate expire_health/forget_health and least_health
-            auto upgrade = model.write_lock();
-
-            expire_health = health_now() - nmos::fields::registration_expiry_interval(model.settings);
-            forget_health = expire_health - nmos::fields::registration_expiry_interval(model.settings);
+            // the upgrade is atomic, so no other thread can have modified the resources in the meantime
+            nmos::upgrade_to_write_lock upgrade(lock);
 
             // forget all resources expired in the previous interval
             forget_erased_resources(resources, forget_health);
 
             // expire all nodes for which there hasn't been a heartbeat in the last expiry interval
             const auto expired = erase_expired_resources(resources, expire_health, false);
+            model.metrics.resources_expired += expired;
 
             if (0 != expired)
             {
@@ -211,15 +209,13 @@ namespace nmos
             // note that, as elsewhere, http_exception and json_exception are handled by the exception handler added by add_api_finally_handler
             return details::extract_json(req, gate).then([&model, &validator, req, res, parameters, gate](value body) mutable
             {
-                // could start out as a shared/read lock, only upgraded to an exclusive/write lock when the resource is actually modified or inserted into resources
-                auto lock = model.write_lock();
-                auto& resources = model.registry_resources;
-
                 const nmos::api_version version = nmos::parse_api_version(parameters.at(nmos::patterns::version.name));
 
                 // Validate JSON syntax according to the schema
 
-                const bool allow_invalid_resources = nmos::experimental::fields::allow_invalid_resources(model.settings);
+                // schema validation is relatively expensive, and doesn't depend on the registry resources, so it is done before taking the upgrade lock,
+                // which is exclusive of other upgrade (and write) locks, so that concurrent registrations can be validated in parallel
+                const bool allow_invalid_resources = with_read_lock(model.mutex, [&model] { return nmos::experimental::fields::allow_invalid_resources(model.settings); });
                 if (!allow_invalid_resources)
                 {
                     validator.validate(body, experimental::make_registrationapi_resource_post_request_schema_uri(version));
@@ -236,6 +232,10 @@ namespace nmos
                     }
                 }
 
+                // start out as an upgrade lock, shared with readers, only upgraded to an exclusive/write lock when the resource is actually modified or inserted into resources
+                auto lock = model.upgrade_lock();
+                auto& resources = model.registry_resources;
+
                 const value data = nmos::fields::data(body);
                 const std::pair<nmos::id, nmos::type> id_type{ nmos::fields::id(data), nmos::type{ nmos::fields::type(body) } };
                 const auto& id = id_type.first;
@@ -398,6 +398,8 @@ namespace nmos
                 // always reject updates that would modify resource type or super-resource
                 if (valid_type && valid_super_id_type && (valid || allow_invalid_resources))
                 {
+                    nmos::upgrade_to_write_lock upgrade(lock);
+
                     if (creating)
                     {
                         nmos::resource created_resource{ version, type, data, false };
@@ -406,6 +408,7 @@ namespace nmos
                         res.headers().add(web::http::header_names::location, make_registration_api_resource_location(created_resource));
 
                         insert_resource(resources, std::move(created_resource), allow_invalid_resources);
+                        ++model.metrics.registrations_created;
                     }
                     else
                     {
@@ -416,6 +419,7 @@ namespace nmos
                         {
                             resource.data = data;
                         });
+                        ++model.metrics.registrations_updated;
                     }
 
                     slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "At " << nmos::make_version(nmos::tai_now()) << ", the registry contains " << nmos::put_resources_statistics(resources);
@@ -501,6 +505,7 @@ namespace nmos
 
                         const auto health = nmos::health_now();
                         set_resource_health(resources, resource->id, health);
+                        ++model.metrics.heartbeats;
 
                         set_reply(res, web::http::status_codes::OK, make_health_response_body(health));
                     }
@@ -576,8 +581,8 @@ namespace nmos
         {
             nmos::api_gate gate(gate_, req, parameters);
 
-            // could start out as a shared/read lock, only upgraded to an exclusive/write lock when the resource is actually deleted from resources
-            auto lock = model.write_lock();
+            // start out as an upgrade lock, shared with readers, only upgraded to an exclusive/write lock when the resource is actually deleted from resources
+            auto lock = model.upgrade_lock();
             auto& resources = model.registry_resources;
 
             const nmos::api_version version = nmos::parse_api_version(parameters.at(nmos::patterns::version.name));
@@ -591,6 +596,8 @@ namespace nmos
                 {
                     slog::log<slog::severities::info>(gate, SLOG_FLF) << "Deleting resource: " << resourceId;
 
+                    nmos::upgrade_to_write_lock upgrade(lock);
+
                     // remove this resource from its super-resource's sub-resources
                     auto super_resource = nmos::find_resource(resources, nmos::get_super_resource(*resource));
                     if (super_resource != resources.end())
@@ -607,6 +614,7 @@ namespace nmos
                     // on the Node's behalf in order to prevent stale entries remaining in the registry."
                     // See https://github.com/AMWA-TV/nmos-discovery-registration/blob/v1.2/docs/4.1.%20Behaviour%20-%20Registration.md#controlled-unregistration
                     erase_resource(resources, resource->id, false);
+                    ++model.metrics.registrations_deleted;
 
                     slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying query websockets thread"; // and anyone else who cares...
                     model.notify();
@@ -0,0 +1,305 @@
+#include "nmos/registry_persistence.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+#include <boost/range/adaptor/filtered.hpp>
+#include "cpprest/json_utils.h"
+#include "nmos/api_version.h"
+#include "nmos/model.h"
+#include "nmos/slog.h"
+#include "nmos/thread_utils.h"
+#include "nmos/version.h"
+
+// std::rename does not replace an existing file on Windows, and removing it first would leave no snapshot at all if the registry stopped in between
+#if defined(_WIN32)
+extern "C" __declspec(dllimport) int __stdcall MoveFileExA(const char* lpExistingFileName, const char* lpNewFileName, unsigned long dwFlags);
+#endif
+
+namespace nmos
+{
+    namespace experimental
+    {
+        namespace details
+        {
+            namespace fields
+            {
+                const web::json::field_as_string version{ U("version") };
+                const web::json::field_as_value downgrade_version{ U("downgrade_version") };
+                const web::json::field_as_string type{ U("type") };
+                const web::json::field_as_string id{ U("id") };
+                const web::json::field_as_string created{ U("created") };
+                const web::json::field_as_string updated{ U("updated") };
+                const web::json::field_as_number health{ U("health") };
+                const web::json::field_as_number saved{ U("saved") };
+                const web::json::field_as_value data{ U("data") };
+            }
+
+            inline std::string make_snapshot_path(const utility::string_t& path) { return utility::us2s(path) + "/registry.json"; }
+            inline std::string make_log_path(const utility::string_t& path) { return utility::us2s(path) + "/registry.wal"; }
+
+            // the registry's own resources are recreated on startup, and never expire, so are not persisted
+            inline bool is_persistent(const nmos::resource& resource)
+            {
+                return nmos::health_forever != resource.health;
+            }
+
+            // a persisted resource is an extant resource, or a resource that has been erased (with null data)
+            web::json::value make_persisted_resource(const nmos::resource& resource, nmos::health saved)
+            {
+                return web::json::value_of({
+                    { fields::version, nmos::make_api_version(resource.version) },
+                    { fields::downgrade_version, nmos::api_version{} != resource.downgrade_version ? web::json::value::string(nmos::make_api_version(resource.downgrade_version)) : web::json::value::null() },
+                    { fields::type, resource.type.name },
+                    { fields::id, resource.id },
+                    { fields::created, nmos::make_version(resource.created) },
+                    { fields::updated, nmos::make_version(resource.updated) },
+                    { fields::health, resource.health.load() },
+                    { fields::saved, saved },
+                    { fields::data, resource.data }
+                });
+            }
+
+            // keep the most recently updated of each persisted resource, or when the update timestamps are equal, e.g. because the resource
+            // has since expired, which does not set the update timestamp, the most recently saved
+            void restore_persisted_resource(std::map<nmos::id, web::json::value>& restored, web::json::value persisted)
+            {
+                auto& existing = restored[fields::id(persisted)];
+                if (existing.is_null())
+                {
+                    existing = std::move(persisted);
+                    return;
+                }
+                const auto existing_updated = nmos::parse_version(fields::updated(existing));
+                const auto persisted_updated = nmos::parse_version(fields::updated(persisted));
+                if (existing_updated < persisted_updated || (existing_updated == persisted_updated && fields::saved(existing).to_int64() <= fields::saved(persisted).to_int64()))
+                {
+                    existing = std::move(persisted);
+                }
+            }
+
+            // replace the file at the specified path, atomically, so that a complete file is always there
+            bool replace_file(const std::string& from, const std::string& to)
+            {
+#if defined(_WIN32)
+                // MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH
+                return 0 != MoveFileExA(from.c_str(), to.c_str(), 0x1 | 0x8);
+#else
+                return 0 == std::rename(from.c_str(), to.c_str());
+#endif
+            }
+        }
+
+        // restore the registry resources from the snapshot and write-ahead log in the configured directory, if any,
+        // with their original creation and update timestamps, and with their health adjusted by the time for which the registry was down,
+        // so that nothing expires just because the registry was down
+        // returns the number of resources restored
+        // (this should be called before the server is opened, so does not lock the model mutex)
+        std::size_t restore_registry_resources(nmos::registry_model& model, slog::base_gate& gate)
+        {
+            const auto path = nmos::experimental::fields::registry_persistence_path(model.settings);
+            if (path.empty()) return 0;
+
+            auto& resources = model.registry_resources;
+
+            std::map<nmos::id, web::json::value> restored;
+
+            std::ifstream snapshot_file(details::make_snapshot_path(path));
+            if (snapshot_file.is_open())
+            {
+                std::error_code error;
+                auto snapshot = web::json::value::parse(snapshot_file, error);
+                if (error || !snapshot.is_array())
+                {
+                    slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registry persistence snapshot could not be read [" << error << "]";
+                }
+                else
+                {
+                    for (auto& persisted : snapshot.as_array())
+                    {
+                        details::restore_persisted_resource(restored, std::move(persisted));
+                    }
+                }
+            }
+
+            // since the write-ahead log is only truncated after the snapshot has been written, it may contain records which are older
+            // than the snapshot, and its last record may be incomplete, if the registry was not shut down cleanly
+            std::ifstream log_file(details::make_log_path(path));
+            std::string line;
+            while (std::getline(log_file, line))
+            {
+                if (line.empty()) continue;
+                std::error_code error;
+                auto persisted = web::json::value::parse(utility::s2us(line), error);
+                if (error || !persisted.is_object())
+                {
+                    slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registry persistence log record could not be read [" << error << "]";
+                    continue;
+                }
+                details::restore_persisted_resource(restored, std::move(persisted));
+            }
+
+            if (restored.empty()) return 0;
+
+            // insert the extant resources in creation order, so super-resources are inserted before their sub-resources
+            std::multimap<nmos::tai, const web::json::value*> by_created;
+            nmos::health saved = 0;
+            for (const auto& persisted : restored)
+            {
+                const auto persisted_saved = (nmos::health)details::fields::saved(persisted.second).to_int64();
+                if (saved < persisted_saved) saved = persisted_saved;
+
+                if (details::fields::data(persisted.second).is_null()) continue;
+                by_created.insert({ nmos::parse_version(details::fields::created(persisted.second)), &persisted.second });
+            }
+
+            const auto now = nmos::health_now();
+            const auto downtime = (std::max)(nmos::health{ 0 }, now - saved);
+
+            std::size_t count = 0;
+            for (const auto& created_persisted : by_created)
+            {
+                const auto& persisted = *created_persisted.second;
+
+                nmos::resource resource{ nmos::parse_api_version(details::fields::version(persisted)), nmos::type{ details::fields::type(persisted) }, details::fields::data(persisted), false };
+                const auto& downgrade_version = details::fields::downgrade_version(persisted);
+                if (!downgrade_version.is_null()) resource.downgrade_version = nmos::parse_api_version(downgrade_version.as_string());
+
+                // super-resources are inserted first, so there are no sub-resources to search for
+                auto inserted = insert_resource(resources, std::move(resource), false);
+                if (!inserted.second) continue;
+
+                // restore the original creation and update timestamps, which are certainly earlier than those just assigned
+                // so can't clash with those of any other restored resource (replace fails, rather than erasing, if they did)
+                auto restored_resource = *inserted.first;
+                restored_resource.created = created_persisted.first;
+                restored_resource.updated = nmos::parse_version(details::fields::updated(persisted));
+                resources.replace(inserted.first, restored_resource);
+                ++resources.generation;
+
+                // heartbeats aren't logged, so the health of a resource which only appears in the snapshot may be up to the snapshot interval
+                // older than the latest record, therefore each resource is given as long as it had left when it was itself saved
+                // this also updates the health of any sub-resources, which will be restored themselves afterwards
+                const auto resource_downtime = (std::max)(nmos::health{ 0 }, now - (nmos::health)details::fields::saved(persisted).to_int64());
+                nmos::set_resource_health(resources, inserted.first->id, (nmos::health)details::fields::health(persisted).to_int64() + resource_downtime);
+
+                ++count;
+            }
+
+            slog::log<slog::severities::info>(gate, SLOG_FLF) << "Restored " << count << " resources persisted by the registry " << downtime << " seconds ago";
+
+            return count;
+        }
+
+        // append the resources inserted, modified or erased to the write-ahead log, and periodically replace the log with a new snapshot
+        void persist_registry_resources_thread(nmos::registry_model& model, slog::base_gate& gate_)
+        {
+            nmos::details::omanip_gate gate(gate_, nmos::stash_category(nmos::categories::registry_persistence));
+            nmos::experimental::mutex_category_guard mutex_category(nmos::categories::registry_persistence);
+
+            auto lock = model.read_lock();
+            auto& resources = model.registry_resources;
+
+            const auto path = nmos::experimental::fields::registry_persistence_path(model.settings);
+            if (path.empty()) return;
+            const auto snapshot_interval = std::chrono::seconds((std::max)(1, nmos::experimental::fields::registry_snapshot_interval(model.settings)));
+
+            // start with a snapshot, which also incorporates any restored resources
+            auto next_snapshot = std::chrono::steady_clock::now();
+            nmos::tai persisted_until;
+            std::uint64_t persisted_generation = 0;
+
+            // expiry does not set the update timestamp, so the erased resources which have already been persisted are tracked,
+            // in order to also append a record for each resource which has expired since
+            std::set<nmos::id> persisted_erased;
+
+            for (;;)
+            {
+                // a final snapshot is made on shutdown, to persist the most recent health of each resource
+                const bool snapshot = model.shutdown || std::chrono::steady_clock::now() >= next_snapshot;
+                const auto saved = nmos::health_now();
+
+                // serialize the resources while holding the read lock, but write them after releasing it
+                std::string records;
+                std::size_t count = 0;
+                if (snapshot)
+                {
+                    auto persistent = resources | boost::adaptors::filtered([](const nmos::resource& resource) { return resource.has_data() && details::is_persistent(resource); });
+                    records = utility::us2s(web::json::serialize(persistent, [&saved, &count](const nmos::resource& resource) { ++count; return details::make_persisted_resource(resource, saved); }));
+                }
+                else
+                {
+                    auto& by_updated = resources.get<tags::updated>();
+                    for (auto resource = by_updated.begin(); by_updated.end() != resource && resource->updated > persisted_until; ++resource)
+                    {
+                        if (!details::is_persistent(*resource)) continue;
+                        records += utility::us2s(details::make_persisted_resource(*resource, saved).serialize());
+                        records += '\n';
+                        ++count;
+                    }
+                }
+
+                std::set<nmos::id> erased;
+                auto& by_type = resources.get<tags::type>();
+                const auto erased_range = by_type.equal_range(false);
+                for (auto resource = erased_range.first; erased_range.second != resource; ++resource)
+                {
+                    if (!details::is_persistent(*resource)) continue;
+                    erased.insert(resource->id);
+
+                    // a resource erased since the last pass has already been appended above, and erased resources are omitted from a snapshot
+                    if (snapshot || resource->updated > persisted_until || persisted_erased.end() != persisted_erased.find(resource->id)) continue;
+                    records += utility::us2s(details::make_persisted_resource(*resource, saved).serialize());
+                    records += '\n';
+                    ++count;
+                }
+                persisted_erased.swap(erased);
+
+                persisted_until = most_recent_update(resources);
+                persisted_generation = resources.generation;
+                const bool shutdown = model.shutdown;
+
+                lock.unlock();
+
+                if (snapshot)
+                {
+                    // write the new snapshot alongside the old one, and only truncate the log once it has been put in place
+                    const auto snapshot_path = details::make_snapshot_path(path);
+                    const auto temp_path = snapshot_path + ".tmp";
+                    bool written = false;
+                    {
+                        std::ofstream snapshot_file(temp_path, std::ios_base::out | std::ios_base::trunc);
+                        written = (bool)(snapshot_file << records << std::flush);
+                    }
+                    if (written && details::replace_file(temp_path, snapshot_path))
+                    {
+                        std::ofstream log_file(details::make_log_path(path), std::ios_base::out | std::ios_base::trunc);
+                        slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Registry persistence snapshot written with " << count << " resources";
+                    }
+                    else
+                    {
+                        slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registry persistence snapshot could not be written to: " << snapshot_path;
+                    }
+                    next_snapshot = std::chrono::steady_clock::now() + snapshot_interval;
+                }
+                else if (0 != count)
+                {
+                    std::ofstream log_file(details::make_log_path(path), std::ios_base::out | std::ios_base::app);
+                    if (!(log_file << records << std::flush))
+                    {
+                        slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registry persistence log could not be written to: " << details::make_log_path(path);
+                    }
+                }
+
+                lock.lock();
+
+                if (shutdown) break;
+
+                // wait for the resources to be inserted, modified, erased or expired, or for the next snapshot to be due, or the server to be shut down
+                model.wait_until(lock, next_snapshot, [&] { return model.shutdown || resources.generation != persisted_generation; });
+            }
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef NMOS_REGISTRY_PERSISTENCE_H
+#define NMOS_REGISTRY_PERSISTENCE_H
+
+#include <cstddef>
+#include "cpprest/details/basic_types.h"
+
+namespace slog
+{
+    class base_gate;
+}
+
+// This is an experimental extension to persist the registry resources, so that a restarted registry can resume immediately
+// without every node on the site having to re-register all its resources at once
+// The persisted state is a snapshot of the registered resources, and a write-ahead log of the resources inserted, modified or erased since
+// See nmos::experimental::fields::registry_persistence_path
+namespace nmos
+{
+    struct registry_model;
+
+    namespace experimental
+    {
+        // restore the registry resources from the snapshot and write-ahead log in the configured directory, if any,
+        // with their original creation and update timestamps, and with their health adjusted by the time for which the registry was down,
+        // so that nothing expires just because the registry was down
+        // returns the number of resources restored
+        // (this should be called before the server is opened, so does not lock the model mutex)
+        std::size_t restore_registry_resources(nmos::registry_model& model, slog::base_gate& gate);
+
+        // append the resources inserted, modified or erased to the write-ahead log, and periodically replace the log with a new snapshot
+        void persist_registry_resources_thread(nmos::registry_model& model, slog::base_gate& gate);
+    }
+}
+
+#endif
@@ -0,0 +1,294 @@
+#include "nmos/registry_replica.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <set>
+#include "cpprest/http_client.h"
+#include "cpprest/uri_schemes.h"
+#include "cpprest/ws_client.h"
+#include "nmos/client_utils.h"
+#include "nmos/model.h"
+#include "nmos/query_utils.h"
+#include "nmos/slog.h"
+#include "nmos/thread_utils.h" // for wait_until, reverse_lock_guard
+
+namespace nmos
+{
+    namespace experimental
+    {
+        namespace details
+        {
+            // the resource types which are replicated; the subscription, whose resource_path is empty, also matches e.g. subscriptions, which are not
+            const std::vector<nmos::type> replicated_types{ nmos::types::node, nmos::types::device, nmos::types::source, nmos::types::flow, nmos::types::sender, nmos::types::receiver };
+
+            bool is_replicated_type(const nmos::type& type)
+            {
+                return replicated_types.end() != std::find(replicated_types.begin(), replicated_types.end(), type);
+            }
+
+            // the quiet period after which the 'sync' events are assumed to be complete, if no other events have been received;
+            // the primary registry sends each page of them as soon as the previous one, since max_update_rate_ms is zero
+            const auto sync_interval = std::chrono::seconds(1);
+
+            // the state of the Query WebSocket API connection
+            // (protected by the model mutex)
+            struct replica_connection
+            {
+                // the quiet period starts when the connection is opened, since there are no 'sync' events if the primary registry has no resources
+                replica_connection() : synced(false), closed(false), most_recent_message(std::chrono::steady_clock::now()) {}
+
+                // the 'sync' events for all the resources are paged over the first messages on the connection (see query_ws_paging_default),
+                // so resources which were removed while the connection was down can only be identified once they have all been received
+                bool synced;
+                std::set<nmos::id> synced_ids;
+                bool closed;
+                std::chrono::steady_clock::time_point most_recent_message;
+            };
+
+            // join each resource to its super-resource, in a single pass, since the 'sync' events are not necessarily in the order
+            // that the resources were created
+            void join_sub_resources(nmos::resources& resources)
+            {
+                for (const auto& resource : resources)
+                {
+                    if (!resource.has_data()) continue;
+
+                    auto super_resource = find_resource(resources, get_super_resource(resource));
+                    if (resources.end() == super_resource) continue;
+
+                    // sub_resources is not a key, so this does not invalidate the iteration
+                    resources.modify(super_resource, [&resource](nmos::resource& super_resource)
+                    {
+                        super_resource.sub_resources.insert(resource.id);
+                    });
+                }
+            }
+
+            // forget any replicated resources which were removed while the connection was down
+            // (lock the model mutex, for write, before calling this)
+            void complete_sync(nmos::resources& resources, replica_connection& connection, slog::base_gate& gate)
+            {
+                std::vector<nmos::id> removed_ids;
+                for (const auto& resource : resources)
+                {
+                    if (!resource.has_data() || !is_replicated_type(resource.type)) continue;
+                    if (connection.synced_ids.end() == connection.synced_ids.find(resource.id)) removed_ids.push_back(resource.id);
+                }
+                for (const auto& id : removed_ids)
+                {
+                    erase_resource(resources, id, false);
+                }
+
+                join_sub_resources(resources);
+
+                slog::log<slog::severities::info>(gate, SLOG_FLF) << "Replicated " << connection.synced_ids.size() << " resources, and removed " << removed_ids.size();
+
+                connection.synced = true;
+                connection.synced_ids.clear();
+            }
+
+            // apply the resource events in the specified Query WebSocket API message to the replicated resources
+            // (lock the model mutex, for write, before calling this)
+            void apply_resource_events(nmos::resources& resources, const nmos::api_version& version, replica_connection& connection, const web::json::value& message, slog::base_gate& gate)
+            {
+                connection.most_recent_message = std::chrono::steady_clock::now();
+
+                const auto topic = nmos::fields::grain_topic(message);
+                const auto& events = nmos::fields::grain_data(message).as_array();
+
+                for (const auto& event : events)
+                {
+                    const auto id_type = nmos::details::get_resource_event_resource(topic, event);
+                    if (!is_replicated_type(id_type.second)) continue;
+
+                    const auto event_type = nmos::details::get_resource_event_type(event);
+
+                    // the 'sync' events are complete once any other event is received
+                    if (!connection.synced)
+                    {
+                        if (nmos::details::resource_unchanged_event == event_type)
+                        {
+                            connection.synced_ids.insert(id_type.first);
+                        }
+                        else
+                        {
+                            complete_sync(resources, connection, gate);
+                        }
+                    }
+
+                    if (nmos::details::resource_removed_event == event_type)
+                    {
+                        erase_resource(resources, id_type.first, false);
+                        continue;
+                    }
+                    if (nmos::details::resource_continued_nonexistence_event == event_type) continue;
+
+                    const auto& post = event.at(U("post"));
+
+                    // since the resource_path of the subscription is empty, the API version of each resource is included unless it is the same as the subscription
+                    const auto resource_version = event.has_field(nmos::experimental::fields::api_version) ? nmos::experimental::fields::api_version(event) : version;
+
+                    auto found = find_resource(resources, id_type);
+                    if (resources.end() != found && found->has_data())
+                    {
+                        if (found->data != post || found->version != resource_version)
+                        {
+                            modify_resource(resources, id_type.first, [&post, &resource_version](nmos::resource& resource)
+                            {
+                                resource.version = resource_version;
+                                resource.data = post;
+                            });
+                        }
+                    }
+                    else
+                    {
+                        // replicated resources never expire, they are only erased when the primary registry erases them
+                        // sub-resources inserted before their super-resource are joined to it in a single pass when the 'sync' events are complete,
+                        // rather than by searching all the resources on every insertion; after that, events are in the order they were made
+                        insert_resource(resources, nmos::resource{ resource_version, id_type.second, post, true }, false);
+                    }
+                }
+
+                slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Replicated " << events.size() << " changes";
+            }
+        }
+
+        // subscribe to the Query WebSocket API of the primary registry, and apply the received resource events
+        // to the registry resources of this replica, resynchronizing after any connection failure
+        void replicate_registry_resources_thread(nmos::registry_model& model, slog::base_gate& gate_)
+        {
+            nmos::details::omanip_gate gate(gate_, nmos::stash_category(nmos::categories::registry_replication));
+            nmos::experimental::mutex_category_guard mutex_category(nmos::categories::registry_replication);
+
+            auto lock = model.write_lock();
+            auto& resources = model.registry_resources;
+
+            // the Query API base URI of the primary registry includes the API version, e.g. "http://primary.example.com:3211/x-nmos/query/v1.3"
+            const web::uri source(nmos::experimental::fields::registry_replica_source(model.settings));
+            const auto segments = web::uri::split_path(source.path());
+            const auto version = !segments.empty() ? nmos::parse_api_version(segments.back()) : nmos::api_version{};
+
+            const auto http_config = nmos::make_http_client_config(model.settings);
+            const auto websocket_config = nmos::make_websocket_client_config(model.settings);
+
+            // the retry delay is arbitrary, but avoids hammering a primary registry which is restarting
+            const auto retry_interval = std::chrono::seconds(1);
+
+            while (!model.shutdown)
+            {
+                std::shared_ptr<details::replica_connection> connection;
+                std::unique_ptr<web::websockets::client::websocket_callback_client> ws_client;
+
+                try
+                {
+                    details::reverse_lock_guard<nmos::write_lock> unlock{ lock };
+
+                    web::http::client::http_client client(source, http_config);
+
+                    // create a non-persistent subscription, which the primary registry deletes when the connection is closed
+                    // the resource_path is empty, to match resources of all types in a single ordered stream of events, and the experimental
+                    // query.downgrade and query.strip parameters request resources of every version of this major version, not stripped,
+                    // since the resources are stored at their own version
+                    const auto subscription_request = web::json::value_of({
+                        { nmos::fields::max_update_rate_ms, 0 },
+                        { nmos::fields::resource_path, U("") },
+                        { nmos::fields::params, web::json::value_of({
+                            { U("query.downgrade"), nmos::make_api_version({ version.major, 0 }) },
+                            { U("query.strip"), false }
+                        }) },
+                        { nmos::fields::persist, false },
+                        { nmos::fields::secure, web::uri_schemes::https == source.scheme() }
+                    });
+
+                    auto response = client.request(web::http::methods::POST, U("/subscriptions"), subscription_request).get();
+                    if (web::http::status_codes::OK != response.status_code() && web::http::status_codes::Created != response.status_code())
+                    {
+                        throw web::http::http_exception(U("Subscription to the primary registry failed with status code: ") + utility::ostringstreamed(response.status_code()));
+                    }
+                    const auto subscription = response.extract_json().get();
+                    const web::uri ws_href(nmos::fields::ws_href(subscription));
+
+                    auto new_connection = std::make_shared<details::replica_connection>();
+                    ws_client.reset(new web::websockets::client::websocket_callback_client(websocket_config));
+
+                    ws_client->set_message_handler([&model, &resources, version, new_connection, &gate](const web::websockets::client::websocket_incoming_message& msg)
+                    {
+                        try
+                        {
+                            const auto message = web::json::value::parse(utility::conversions::to_string_t(msg.extract_string().get()));
+
+                            auto lock = model.write_lock();
+                            details::apply_resource_events(resources, version, *new_connection, message, gate);
+                            model.notify();
+                        }
+                        catch (const web::json::json_exception& e)
+                        {
+                            slog::log<slog::severities::warning>(gate, SLOG_FLF) << "JSON error: " << e.what();
+                        }
+                    });
+
+                    ws_client->set_close_handler([&model, new_connection, ws_href, &gate](web::websockets::client::websocket_close_status close_status, const utility::string_t& close_reason, const std::error_code& error)
+                    {
+                        slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Closing websocket connection to: " << ws_href.to_string() << " [" << (int)close_status << ": " << close_reason << "]";
+
+                        auto lock = model.write_lock();
+                        new_connection->closed = true;
+                        model.notify();
+                    });
+
+                    ws_client->connect(ws_href).wait();
+
+                    connection = new_connection;
+
+                    slog::log<slog::severities::info>(gate, SLOG_FLF) << "Replicating from: " << ws_href.to_string();
+                }
+                catch (const web::http::http_exception& e)
+                {
+                    slog::log<slog::severities::error>(gate, SLOG_FLF) << "HTTP error: " << e.what() << " [" << e.error_code() << "]";
+                }
+                catch (const web::websockets::client::websocket_exception& e)
+                {
+                    slog::log<slog::severities::error>(gate, SLOG_FLF) << "WebSocket error: " << e.what() << " [" << e.error_code() << "]";
+                }
+                catch (const web::json::json_exception& e)
+                {
+                    slog::log<slog::severities::error>(gate, SLOG_FLF) << "JSON error: " << e.what();
+                }
+
+                if (connection)
+                {
+                    // wait until the 'sync' events are complete, which, unless another event arrives first, is after a quiet period
+                    while (!model.shutdown && !connection->closed && !connection->synced)
+                    {
+                        const auto sync_deadline = connection->most_recent_message + details::sync_interval;
+                        if (std::chrono::steady_clock::now() < sync_deadline)
+                        {
+                            model.wait_until(lock, sync_deadline, [&] { return model.shutdown || connection->closed || connection->synced; });
+                        }
+                        else
+                        {
+                            details::complete_sync(resources, *connection, gate);
+                            model.notify();
+                        }
+                    }
+
+                    // wait until the connection is closed, or the server is being shut down
+                    model.wait(lock, [&] { return model.shutdown || connection->closed; });
+                }
+
+                // close the connection, and resynchronize on reconnection
+                if (ws_client)
+                {
+                    details::reverse_lock_guard<nmos::write_lock> unlock{ lock };
+                    ws_client->close().wait();
+                }
+
+                if (!model.shutdown)
+                {
+                    model.wait_for(lock, retry_interval, [&] { return model.shutdown; });
+                }
+            }
+        }
+    }
+}
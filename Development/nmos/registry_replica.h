@@ -0,0 +1,25 @@
+#ifndef NMOS_REGISTRY_REPLICA_H
+#define NMOS_REGISTRY_REPLICA_H
+
+namespace slog
+{
+    class base_gate;
+}
+
+// This is an experimental extension to support read-only replicas of a registry, in order to scale the Query API horizontally
+// The change stream of the primary registry is its Query WebSocket API, which already publishes an ordered stream of resource events,
+// each with the "pre" and "post" representation of an inserted, modified or erased resource
+// See nmos::experimental::fields::registry_replica_source
+namespace nmos
+{
+    struct registry_model;
+
+    namespace experimental
+    {
+        // subscribe to the Query WebSocket API of the primary registry, and apply the received resource events
+        // to the registry resources of this replica, resynchronizing after any connection failure
+        void replicate_registry_resources_thread(nmos::registry_model& model, slog::base_gate& gate);
+    }
+}
+
+#endif
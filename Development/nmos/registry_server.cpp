@@ -9,10 +9,13 @@
 #include "nmos/model.h"
 #include "nmos/mdns.h"
 #include "nmos/mdns_api.h"
+#include "nmos/metrics_api.h"
 #include "nmos/node_api.h"
 #include "nmos/query_api.h"
 #include "nmos/query_ws_api.h"
 #include "nmos/registration_api.h"
+#include "nmos/registry_persistence.h"
+#include "nmos/registry_replica.h"
 #include "nmos/registry_resources.h"
 #include "nmos/server.h"
 #include "nmos/server_utils.h"
@@ -42,6 +45,9 @@ namespace nmos
 
             const auto server_secure = nmos::experimental::fields::server_secure(registry_model.settings);
 
+            // a read-only replica of a primary registry serves only the Query API and Query WebSocket API (as well as the experimental APIs)
+            const bool replica = !nmos::experimental::fields::registry_replica_source(registry_model.settings).empty();
+
             // Configure the DNS-SD Browsing API
 
             const host_port mdns_address(nmos::experimental::fields::mdns_address(registry_model.settings), nmos::experimental::fields::mdns_port(registry_model.settings));
@@ -52,6 +58,9 @@ namespace nmos
             const host_port settings_address(nmos::experimental::fields::settings_address(registry_model.settings), nmos::experimental::fields::settings_port(registry_model.settings));
             registry_server.api_routers[settings_address].mount({}, nmos::experimental::make_settings_api(registry_model, log_model, gate));
 
+            // the Settings API also exposes lock statistics for the model mutex, if enabled
+            registry_model.mutex.enable_statistics(nmos::experimental::fields::mutex_statistics(registry_model.settings));
+
             // Configure the Logging API
 
             const host_port logging_address(nmos::experimental::fields::logging_address(registry_model.settings), nmos::experimental::fields::logging_port(registry_model.settings));
@@ -68,28 +77,39 @@ namespace nmos
             auto& query_ws_api = registry_server.ws_handlers[{ {}, nmos::fields::query_ws_port(registry_model.settings) }];
             query_ws_api.first = nmos::make_query_ws_api(query_id, registry_model, query_ws_api.second, gate);
 
-            // Configure the Registration API
+            // Configure the Metrics API
+
+            const host_port metrics_address(nmos::experimental::fields::metrics_address(registry_model.settings), nmos::experimental::fields::metrics_port(registry_model.settings));
+            registry_server.api_routers[metrics_address].mount({}, nmos::experimental::make_metrics_api(registry_model, query_ws_api.second, log_model, gate));
+
+            if (!replica)
+            {
+                // Configure the Registration API
+
+                registry_server.api_routers[{ {}, nmos::fields::registration_port(registry_model.settings) }].mount({}, nmos::make_registration_api(registry_model, gate));
 
-            registry_server.api_routers[{ {}, nmos::fields::registration_port(registry_model.settings) }].mount({}, nmos::make_registration_api(registry_model, gate));
+                // Configure the Node API
 
-            // Configure the Node API
+                registry_server.api_routers[{ {}, nmos::fields::node_port(registry_model.settings) }].mount({}, nmos::make_node_api(registry_model, {}, gate));
 
-            registry_server.api_routers[{ {}, nmos::fields::node_port(registry_model.settings) }].mount({}, nmos::make_node_api(registry_model, {}, gate));
+                // set up the node resources
+                auto& self_resources = registry_model.node_resources;
+                nmos::experimental::insert_registry_resources(self_resources, registry_model.settings);
 
-            // set up the node resources
-            auto& self_resources = registry_model.node_resources;
-            nmos::experimental::insert_registry_resources(self_resources, registry_model.settings);
+                // add the self resources to the Registration API resources
+                // (for now just copy them directly, since these resources currently do not change and are configured to never expire)
+                registry_model.registry_resources.insert(self_resources.begin(), self_resources.end());
 
-            // add the self resources to the Registration API resources
-            // (for now just copy them directly, since these resources currently do not change and are configured to never expire)
-            registry_model.registry_resources.insert(self_resources.begin(), self_resources.end());
+                // restore the resources persisted by a previous instance, if enabled
+                nmos::experimental::restore_registry_resources(registry_model, gate);
 
-            // Configure the System API
+                // Configure the System API
 
-            // set up the system global configuration resource
-            nmos::experimental::assign_system_global_resource(registry_model.system_global_resource, registry_model.settings);
+                // set up the system global configuration resource
+                nmos::experimental::assign_system_global_resource(registry_model.system_global_resource, registry_model.settings);
 
-            registry_server.api_routers[{ {}, nmos::fields::system_port(registry_model.settings) }].mount({}, nmos::make_system_api(registry_model, gate));
+                registry_server.api_routers[{ {}, nmos::fields::system_port(registry_model.settings) }].mount({}, nmos::make_system_api(registry_model, gate));
+            }
 
             // Configure the Admin UI
 
@@ -103,11 +123,14 @@ namespace nmos
 
             for (auto& api_router : registry_server.api_routers)
             {
+                // record per-route request counts and latencies, exposed via the Metrics API
+                api_router.second.set_statistics_handler(nmos::experimental::make_route_statistics_handler(registry_model.metrics.routes));
+
                 // default empty string means the wildcard address
                 const auto& host = !api_router.first.first.empty() ? api_router.first.first : web::http::experimental::listener::host_wildcard;
                 // map the configured client port to the server port on which to listen
                 // hmm, this should probably also take account of the address
-                registry_server.http_listeners.push_back(nmos::make_api_listener(server_secure, host, nmos::experimental::server_port(api_router.first.second, registry_model.settings), api_router.second, http_config, gate));
+                registry_server.http_listeners.push_back(nmos::make_api_listener(server_secure, host, nmos::experimental::server_port(api_router.first.second, registry_model.settings), api_router.second, http_config, nmos::experimental::fields::http_compression_threshold(registry_model.settings), gate));
             }
 
             // Set up the handlers for each WebSocket API port
@@ -134,6 +157,15 @@ namespace nmos
                 [&] { nmos::advertise_registry_thread(registry_model, gate); }
             });
 
+            if (replica)
+            {
+                registry_server.thread_functions.push_back([&] { nmos::experimental::replicate_registry_resources_thread(registry_model, gate); });
+            }
+            else if (!nmos::experimental::fields::registry_persistence_path(registry_model.settings).empty())
+            {
+                registry_server.thread_functions.push_back([&] { nmos::experimental::persist_registry_resources_thread(registry_model, gate); });
+            }
+
             return registry_server;
         }
     }
@@ -150,9 +182,14 @@ namespace nmos
         if (nmos::service_priorities::no_priority != pri) // no_priority allows the registry to run unadvertised
         {
             nmos::experimental::register_service(advertiser, nmos::service_types::query, model.settings);
-            nmos::experimental::register_service(advertiser, nmos::service_types::registration, model.settings);
-            nmos::experimental::register_service(advertiser, nmos::service_types::node, model.settings);
-            nmos::experimental::register_service(advertiser, nmos::service_types::system, model.settings);
+
+            // a read-only replica only advertises its Query API
+            if (nmos::experimental::fields::registry_replica_source(model.settings).empty())
+            {
+                nmos::experimental::register_service(advertiser, nmos::service_types::registration, model.settings);
+                nmos::experimental::register_service(advertiser, nmos::service_types::node, model.settings);
+                nmos::experimental::register_service(advertiser, nmos::service_types::system, model.settings);
+            }
         }
 
         // wait for the thread to be interrupted because the server is being shut down
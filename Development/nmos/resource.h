@@ -1,7 +1,11 @@
 #ifndef NMOS_RESOURCE_H
 #define NMOS_RESOURCE_H
 
+#include <map>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <vector>
 #include "nmos/api_version.h"
 #include "nmos/copyable_atomic.h"
 #include "nmos/json_fields.h"
@@ -13,6 +17,139 @@
 
 namespace nmos
 {
+    namespace details
+    {
+        // Lazily built, immutable, serialized forms of the resource data, for each API version to which it is downgraded
+        // and other renderings of the resource data, such as a sender's transport file in an alternative format
+        // The cache is invalidated whenever the resource is updated, and is deliberately not copied along with the resource,
+        // since it is only valid for the data from which it was built
+        class serialized_data_cache
+        {
+        public:
+            typedef std::shared_ptr<const utility::string_t> value_type;
+            typedef std::shared_ptr<const std::vector<uint8_t>> compressed_type;
+
+            serialized_data_cache() {}
+            serialized_data_cache(const serialized_data_cache&) {}
+            serialized_data_cache& operator=(const serialized_data_cache& other) { if (this != &other) clear(); return *this; }
+
+            // get the cached serialization for the specified API version, if the resource has not been updated since it was built,
+            // otherwise build it using the specified function and cache it
+            // concurrent readers may build the same serialization, but only one will be kept
+            template <typename Serialize>
+            value_type get(const nmos::api_version& version, const nmos::tai& updated, Serialize serialize) const
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (updated == cached_updated)
+                    {
+                        auto found = cache.find(version);
+                        if (cache.end() != found) return found->second;
+                    }
+                }
+
+                value_type serialized = std::make_shared<const utility::string_t>(serialize());
+
+                std::lock_guard<std::mutex> lock(mutex);
+                invalidate(updated);
+                return cache.insert({ version, serialized }).first->second;
+            }
+
+            // get the cached rendering with the specified name, if the resource has not been updated since it was built,
+            // otherwise build it using the specified function and cache it
+            template <typename Render>
+            value_type get_rendered(const utility::string_t& name, const nmos::tai& updated, Render render) const
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (updated == cached_updated)
+                    {
+                        auto found = rendered_cache.find(name);
+                        if (rendered_cache.end() != found) return found->second;
+                    }
+                }
+
+                value_type rendered = std::make_shared<const utility::string_t>(render());
+
+                std::lock_guard<std::mutex> lock(mutex);
+                invalidate(updated);
+                return rendered_cache.insert({ name, rendered }).first->second;
+            }
+
+            // get the cached compressed form of the specified serialization, with the specified content coding, or build it using the specified function
+            // and cache it, as long as the serialization itself came from this cache and so will be invalidated along with it
+            template <typename Compress>
+            compressed_type get_compressed(const value_type& serialized, const utility::string_t& content_encoding, Compress compress) const
+            {
+                const auto key = std::make_pair(serialized.get(), content_encoding);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    auto found = compressed_cache.find(key);
+                    if (compressed_cache.end() != found) return found->second;
+                }
+
+                compressed_type compressed = std::make_shared<const std::vector<uint8_t>>(compress(*serialized));
+
+                std::lock_guard<std::mutex> lock(mutex);
+                for (const auto& cached : cache)
+                {
+                    if (cached.second == serialized) return compressed_cache.insert({ key, compressed }).first->second;
+                }
+                return compressed;
+            }
+
+            // explicitly share the cached serializations of another resource with identical data, e.g. a copy which has not been updated since
+            void assign(const serialized_data_cache& other)
+            {
+                if (this == &other) return;
+                nmos::tai other_updated;
+                std::map<nmos::api_version, value_type> other_cache;
+                std::map<utility::string_t, value_type> other_rendered_cache;
+                std::map<std::pair<const utility::string_t*, utility::string_t>, compressed_type> other_compressed_cache;
+                {
+                    std::lock_guard<std::mutex> lock(other.mutex);
+                    other_updated = other.cached_updated;
+                    other_cache = other.cache;
+                    other_rendered_cache = other.rendered_cache;
+                    other_compressed_cache = other.compressed_cache;
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                cached_updated = other_updated;
+                cache = std::move(other_cache);
+                rendered_cache = std::move(other_rendered_cache);
+                compressed_cache = std::move(other_compressed_cache);
+            }
+
+            void clear()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                cache.clear();
+                rendered_cache.clear();
+                compressed_cache.clear();
+                cached_updated = {};
+            }
+
+        private:
+            // discard everything cached, if it was built before the resource was last updated
+            // (lock the mutex before calling this)
+            void invalidate(const nmos::tai& updated) const
+            {
+                if (updated == cached_updated) return;
+                cache.clear();
+                rendered_cache.clear();
+                compressed_cache.clear();
+                cached_updated = updated;
+            }
+
+            mutable std::mutex mutex;
+            mutable nmos::tai cached_updated;
+            mutable std::map<nmos::api_version, value_type> cache;
+            mutable std::map<utility::string_t, value_type> rendered_cache;
+            mutable std::map<std::pair<const utility::string_t*, utility::string_t>, compressed_type> compressed_cache;
+        };
+    }
+
     // Resources have an API version, resource type and representation as json data
     // Everything else is (internal) registry information: their id, references to their sub-resources, creation and update timestamps,
     // and health which is usually propagated from a node, because only nodes get heartbeats and keep all their sub-resources alive
@@ -64,6 +201,10 @@ namespace nmos
 
         // see https://github.com/AMWA-TV/nmos-discovery-registration/blob/v1.2/docs/4.1.%20Behaviour%20-%20Registration.md#heartbeating
         mutable details::copyable_atomic<nmos::health> health;
+
+        // serialized forms of the resource data, built on demand by API handlers, which only hold a read lock
+        // see nmos::serialize_downgrade
+        mutable details::serialized_data_cache serialized;
     };
 
     namespace details
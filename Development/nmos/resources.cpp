@@ -36,12 +36,37 @@ namespace nmos
         return results;
     }
 
+    // add the specified resource to, or remove it from, the child resources of each of the specified parents
+    // the parents needn't have been inserted (yet), so that they are joined to their children whatever the order of insertion
+    static void join_parent_resources(resources& resources, const id& id, const std::set<nmos::id>& parents)
+    {
+        // the resource's existence, as well as its parents, may affect the result of an ancestry query
+        ++resources.ancestry_generation;
+        for (const auto& parent : parents)
+        {
+            resources.child_resources[parent].insert(id);
+        }
+    }
+
+    static void leave_parent_resources(resources& resources, const id& id, const std::set<nmos::id>& parents)
+    {
+        ++resources.ancestry_generation;
+        for (const auto& parent : parents)
+        {
+            auto found = resources.child_resources.find(parent);
+            if (resources.child_resources.end() == found) continue;
+            found->second.erase(id);
+            if (found->second.empty()) resources.child_resources.erase(found);
+        }
+    }
+
     // insert a resource
     std::pair<resources::iterator, bool> insert_resource(resources& resources, resource&& resource, bool join_sub_resources)
     {
         if (join_sub_resources)
         {
             // join this resource to any sub-resources which were inserted out-of-order
+            // (child resources are tracked whatever the order, see join_parent_resources)
             resource.sub_resources = get_sub_resources(resources, { resource.id, resource.type });
         }
 
@@ -71,7 +96,11 @@ namespace nmos
 
         if (result.second)
         {
+            ++resources.generation;
+
             auto& inserted = *result.first;
+            join_parent_resources(resources, inserted.id, get_parent_resources(inserted));
+
             insert_resource_events(resources, inserted.version, inserted.downgrade_version, inserted.type, web::json::value::null(), inserted.data);
 
             // set the initial health of this resource from the super-resource (if applicable)
@@ -94,6 +123,7 @@ namespace nmos
         if (resources.end() == found || !found->has_data()) return false;
 
         auto pre = found->data;
+        const auto pre_parents = get_parent_resources(*found);
 
         // "If an exception is thrown by some user-provided operation, then the element pointed to by position is erased."
         // This seems too surprising, despite the fact that it means that a modification may have been partially completed,
@@ -119,7 +149,17 @@ namespace nmos
 
         if (result)
         {
+            ++resources.generation;
+
             auto& modified = *found;
+
+            const auto post_parents = get_parent_resources(modified);
+            if (pre_parents != post_parents)
+            {
+                leave_parent_resources(resources, modified.id, pre_parents);
+                join_parent_resources(resources, modified.id, post_parents);
+            }
+
             insert_resource_events(resources, modified.version, modified.downgrade_version, modified.type, pre, modified.data);
         }
 
@@ -152,6 +192,8 @@ namespace nmos
 
             const auto pre = found->data;
 
+            leave_parent_resources(resources, id, get_parent_resources(*found));
+
             auto resource_updated = nmos::strictly_increasing_update(resources);
             resources.modify(found, [&resource_updated](resource& resource)
             {
@@ -161,6 +203,8 @@ namespace nmos
                 resource.updated = resource_updated;
             });
 
+            ++resources.generation;
+
             auto& erased = *found;
             insert_resource_events(resources, erased.version, erased.downgrade_version, erased.type, pre, erased.data);
 
@@ -188,6 +232,8 @@ namespace nmos
             if (found->health < forget_health || found->health == health_forever)
             {
                 found = by_type.erase(found);
+                ++resources.generation;
+                ++resources.ancestry_generation;
                 ++count;
             }
             else
@@ -220,12 +266,15 @@ namespace nmos
 
                 const auto pre = found->data;
 
+                leave_parent_resources(resources, found->id, get_parent_resources(*found));
+
                 by_type.modify(found, [](resource& resource)
                 {
                     resource.data = web::json::value::null();
 
                     // don't set the update timestamp when a resource is expired
                 });
+                ++resources.generation;
 
                 auto& erased = *found;
                 insert_resource_events(resources, erased.version, erased.downgrade_version, erased.type, pre, erased.data);
@@ -393,6 +442,62 @@ namespace nmos
         return result;
     }
 
+    // get the id of each parent of a source or flow, as identified in its "parents"
+    std::set<nmos::id> get_parent_resources(const resource& resource)
+    {
+        std::set<nmos::id> result;
+        if (!resource.has_data()) return result;
+        if (nmos::types::source != resource.type && nmos::types::flow != resource.type) return result;
+        if (!resource.data.has_field(nmos::fields::parents)) return result;
+        for (const auto& parent : nmos::fields::parents(resource.data))
+        {
+            result.insert(parent.as_string());
+        }
+        return result;
+    }
+
+    // get the id of each resource which identifies the specified resource in its "parents"
+    std::set<nmos::id> get_child_resources(const resources& resources, const id& id)
+    {
+        auto found = resources.child_resources.find(id);
+        return resources.child_resources.end() != found ? found->second : std::set<nmos::id>{};
+    }
+
+    // get the id of each ancestor ("parents") or descendant ("children") of the specified resource, up to the specified number of generations (or all, if zero)
+    // using the parents and tracked child resources of each source or flow
+    std::set<nmos::id> get_ancestry(const resources& resources, const id& id, const utility::string_t& ancestry_type, size_t generations)
+    {
+        const bool parents = U("parents") == ancestry_type;
+
+        std::set<nmos::id> result;
+        std::set<nmos::id> generation{ id };
+        for (size_t n = 0; !generation.empty() && (0 == generations || n < generations); ++n)
+        {
+            std::set<nmos::id> next_generation;
+            for (const auto& member : generation)
+            {
+                auto found = find_resource(resources, member);
+                if (resources.end() == found) continue;
+
+                const auto relatives = parents ? get_parent_resources(*found) : get_child_resources(resources, member);
+                for (const auto& relative : relatives)
+                {
+                    // the ancestry graph shouldn't have cycles, but guard against them anyway
+                    if (relative == id || !result.insert(relative).second) continue;
+                    next_generation.insert(relative);
+                }
+            }
+            generation.swap(next_generation);
+        }
+
+        // only include extant resources
+        for (auto it = result.begin(); result.end() != it;)
+        {
+            if (resources.end() == find_resource(resources, *it)) it = result.erase(it); else ++it;
+        }
+        return result;
+    }
+
     namespace details
     {
         // return true if the resource is "erased" but not forgotten
@@ -1,7 +1,10 @@
 #ifndef NMOS_RESOURCES_H
 #define NMOS_RESOURCES_H
 
+#include <cstdint>
 #include <functional>
+#include <set>
+#include <unordered_map>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/composite_key.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -37,19 +40,45 @@ namespace nmos
         inline type_extractor_tuple has_data(const type& type) { return type_extractor_tuple{ true, type }; }
     }
 
-    // the id index ensures resource id is unique
-    // the type index is a composite index incorporating whether the resource has been deleted or expired
-    // the created/updated indices ensure uniqueness to satisfy the requirements of Query API cursor-based paging
-    // and are in descending order to simplify implementation
-    typedef boost::multi_index_container<
-        resource,
-        boost::multi_index::indexed_by<
-            boost::multi_index::hashed_unique<boost::multi_index::tag<tags::id>, details::id_extractor>,
-            boost::multi_index::ordered_non_unique<boost::multi_index::tag<tags::type>, details::type_extractor>,
-            boost::multi_index::ordered_unique<boost::multi_index::tag<tags::created>, details::created_extractor, std::greater<details::created_extractor::result_type>>,
-            boost::multi_index::ordered_unique<boost::multi_index::tag<tags::updated>, details::updated_extractor, std::greater<details::updated_extractor::result_type>>
-        >
-    > resources;
+    namespace details
+    {
+        // the id index ensures resource id is unique
+        // the type index is a composite index incorporating whether the resource has been deleted or expired
+        // the created/updated indices ensure uniqueness to satisfy the requirements of Query API cursor-based paging
+        // and are in descending order to simplify implementation
+        typedef boost::multi_index_container<
+            resource,
+            boost::multi_index::indexed_by<
+                boost::multi_index::hashed_unique<boost::multi_index::tag<tags::id>, details::id_extractor>,
+                boost::multi_index::ordered_non_unique<boost::multi_index::tag<tags::type>, details::type_extractor>,
+                boost::multi_index::ordered_unique<boost::multi_index::tag<tags::created>, details::created_extractor, std::greater<details::created_extractor::result_type>>,
+                boost::multi_index::ordered_unique<boost::multi_index::tag<tags::updated>, details::updated_extractor, std::greater<details::updated_extractor::result_type>>
+            >
+        > resources_container;
+    }
+
+    struct resources : details::resources_container
+    {
+        // incremented by every insertion, modification or erasure by the functions below, including the expiry of resources,
+        // which doesn't set a new update timestamp, so that e.g. snapshots and cached results can be reliably identified
+        // (changes to health, and to the internal bookkeeping of grains and sub-resources, are not counted)
+        std::uint64_t generation = 0;
+
+        // the sources and flows which identify each resource in their "parents", whether or not that resource has been inserted (yet),
+        // are tracked by the functions below in order to optimise ancestry queries (see nmos::get_child_resources)
+        std::unordered_map<nmos::id, std::set<nmos::id>> child_resources;
+
+        // incremented whenever the result of an ancestry query may have changed, i.e. by every insertion, erasure or forgetting of a resource,
+        // and by modifications which change its parents, so that the resolved ancestry of each subscription can be reused by nmos::insert_resource_events
+        // until then (unlike generation, it's not incremented by other modifications)
+        std::uint64_t ancestry_generation = 0;
+        std::uint64_t resolved_ancestries_generation = 0;
+        std::unordered_map<nmos::id, std::set<nmos::id>> resolved_ancestries;
+
+        // experimental extension, if specified, resource events are passed to this handler rather than being inserted into the grains of all matching subscriptions
+        // see nmos::insert_resource_events, and e.g. nmos::experimental::events_subscribers
+        std::function<void(nmos::resources& resources, const nmos::api_version& version, const nmos::api_version& downgrade_version, const nmos::type& type, const web::json::value& pre, const web::json::value& post)> resource_events_handler;
+    };
 
     // Resource creation/update/deletion operations
 
@@ -130,6 +159,17 @@ namespace nmos
     // get the id of each resource with the specified super-resource
     std::set<nmos::id> get_sub_resources(const resources& resources, const std::pair<id, type>& id_type);
 
+    // get the id of each parent of a source or flow, as identified in its "parents"
+    std::set<nmos::id> get_parent_resources(const resource& resource);
+
+    // get the id of each resource which identifies the specified resource in its "parents"
+    std::set<nmos::id> get_child_resources(const resources& resources, const id& id);
+
+    // get the id of each ancestor ("parents") or descendant ("children") of the specified resource, up to the specified number of generations (or all, if zero)
+    // using the parents and tracked child resources of each source or flow
+    // see https://github.com/AMWA-TV/nmos-discovery-registration/blob/v1.2/docs/2.5.%20APIs%20-%20Query%20Parameters.md#ancestry-queries-optional
+    std::set<nmos::id> get_ancestry(const resources& resources, const id& id, const utility::string_t& ancestry_type, size_t generations = 0);
+
     namespace details
     {
         // return true if the resource is "erased" but not forgotten
@@ -0,0 +1,42 @@
+#include "nmos/resources_snapshot.h"
+
+namespace nmos
+{
+    namespace experimental
+    {
+        // get a consistent snapshot of the specified resources, which remains valid after the model mutex is unlocked
+        // (lock the model mutex, for read, before calling this)
+        std::shared_ptr<const nmos::resources> resources_snapshots::get(const nmos::resources& resources, std::chrono::milliseconds refresh_interval) const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            // every insertion, modification, erasure and expiry increments the generation (which is copied with the resources)
+            if (snapshot && resources.generation == snapshot->generation) return snapshot;
+
+            // the previous snapshot is out of date, but avoid copying all the resources more than once per refresh interval
+            const auto now = std::chrono::steady_clock::now();
+            if (snapshot && now < snapshot_taken + refresh_interval) return snapshot;
+
+            auto copy = std::make_shared<nmos::resources>(resources);
+
+            // carry over the serialized data built for the previous snapshot, for resources which have not been updated since
+            // (nor expired, which doesn't set a new update timestamp)
+            if (snapshot)
+            {
+                auto& by_id = snapshot->get<tags::id>();
+                for (const auto& resource : *copy)
+                {
+                    auto found = by_id.find(resource.id);
+                    if (by_id.end() != found && found->updated == resource.updated && found->has_data() == resource.has_data())
+                    {
+                        resource.serialized.assign(found->serialized);
+                    }
+                }
+            }
+
+            snapshot = std::move(copy);
+            snapshot_taken = now;
+            return snapshot;
+        }
+    }
+}
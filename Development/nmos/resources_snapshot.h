@@ -0,0 +1,40 @@
+#ifndef NMOS_RESOURCES_SNAPSHOT_H
+#define NMOS_RESOURCES_SNAPSHOT_H
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include "nmos/resources.h"
+
+// This is an experimental extension to allow API handlers to match, downgrade and serialize resources without holding the model mutex
+namespace nmos
+{
+    namespace experimental
+    {
+        // immutable snapshots of a resources container
+        // a new snapshot is only copied when resources have been inserted, modified, erased or expired since the previous one was taken
+        // (as identified by the generation of the resources), so while the resources are unchanged (e.g. while there are only heartbeats)
+        // taking a snapshot is O(1)
+        // since copying is O(N), while the resources are changing frequently a new snapshot is copied at most once per refresh interval,
+        // so a snapshot may be out of date by up to that interval
+        // note that resource health is not tracked, so the health of resources in a snapshot may be out of date
+        class resources_snapshots
+        {
+        public:
+            resources_snapshots() {}
+            resources_snapshots(const resources_snapshots&) = delete;
+            resources_snapshots& operator=(const resources_snapshots&) = delete;
+
+            // get a consistent snapshot of the specified resources, which remains valid after the model mutex is unlocked
+            // (lock the model mutex, for read, before calling this)
+            std::shared_ptr<const nmos::resources> get(const nmos::resources& resources, std::chrono::milliseconds refresh_interval = std::chrono::milliseconds::zero()) const;
+
+        private:
+            mutable std::mutex mutex;
+            mutable std::shared_ptr<const nmos::resources> snapshot;
+            mutable std::chrono::steady_clock::time_point snapshot_taken;
+        };
+    }
+}
+
+#endif
@@ -42,6 +42,7 @@ namespace nmos
                 //if (!registry) web::json::insert(settings, std::make_pair(nmos::fields::events_ws_port, http_port));
                 web::json::insert(settings, std::make_pair(nmos::experimental::fields::settings_port, http_port));
                 web::json::insert(settings, std::make_pair(nmos::experimental::fields::logging_port, http_port));
+                web::json::insert(settings, std::make_pair(nmos::experimental::fields::metrics_port, http_port));
                 if (registry) web::json::insert(settings, std::make_pair(nmos::experimental::fields::admin_port, http_port));
                 if (registry) web::json::insert(settings, std::make_pair(nmos::experimental::fields::mdns_port, http_port));
             }
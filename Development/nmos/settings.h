@@ -167,6 +167,7 @@ namespace nmos
 
             const web::json::field_as_integer_or settings_port{ U("settings_port"), 3209 };
             const web::json::field_as_integer_or logging_port{ U("logging_port"), 5106 };
+            const web::json::field_as_integer_or metrics_port{ U("metrics_port"), 3218 };
 
             // port numbers [registry]: ports to which clients should connect for each API
             // see http_port
@@ -178,6 +179,7 @@ namespace nmos
 
             const web::json::field_as_string_or settings_address{ U("settings_address"), U("") };
             const web::json::field_as_string_or logging_address{ U("logging_address"), U("") };
+            const web::json::field_as_string_or metrics_address{ U("metrics_address"), U("") };
 
             // addresses [registry]: addresses on which to listen for each API, or empty string for the wildcard address
 
@@ -198,6 +200,42 @@ namespace nmos
             // http_trace [registry, node]: whether server should enable (default) or disable support for HTTP TRACE
             const web::json::field_as_bool_or http_trace{ U("http_trace"), true };
 
+            // mutex_statistics [registry, node]: whether to record acquire-wait and hold-duration histograms for the model mutex, exposed via the Settings API
+            const web::json::field_as_bool_or mutex_statistics{ U("mutex_statistics"), false };
+
+            // http_compression_threshold [registry, node]: minimum size in bytes of an HTTP response body to be compressed, when the request's Accept-Encoding permits "gzip" or "deflate"
+            // (a negative value disables compression)
+            const web::json::field_as_integer_or http_compression_threshold{ U("http_compression_threshold"), 1024 };
+
+            // query_cache_size [registry]: maximum number of Query API result pages to cache, least recently used first to be evicted
+            // (0 disables the cache; a cached page is never returned once the snapshot of the registry resources has been updated, see query_snapshot_interval_ms)
+            const web::json::field_as_integer_or query_cache_size{ U("query_cache_size"), 128 };
+
+            // query_snapshot_interval_ms [registry]: minimum interval in milliseconds between copies of the registry resources used by the Query API, while they are changing
+            // (the resources are only copied when they have changed, but may be up to this interval out of date, so a non-zero interval means the Query API
+            // may not yet reflect a registration which has already been acknowledged; 0 means the Query API is never out of date)
+            const web::json::field_as_integer_or query_snapshot_interval_ms{ U("query_snapshot_interval_ms"), 0 };
+
+            // registry_persistence_path [registry]: directory in which to persist the registered resources, so that they can be restored when the registry is restarted
+            // (empty, the default, disables persistence)
+            const web::json::field_as_string_or registry_persistence_path{ U("registry_persistence_path"), U("") };
+
+            // registry_snapshot_interval [registry]: interval in seconds between snapshots of the registered resources, which replace the write-ahead log of the changes since the previous snapshot
+            const web::json::field_as_integer_or registry_snapshot_interval{ U("registry_snapshot_interval"), 60 };
+
+            // registry_replica_source [registry]: Query API base URI of a primary registry, including the API version, e.g. "http://primary.example.com:3211/x-nmos/query/v1.3"
+            // when specified, this registry is a read-only replica of the primary, serving only the Query API and Query WebSocket API
+            // (empty, the default, means this registry is not a replica)
+            const web::json::field_as_string_or registry_replica_source{ U("registry_replica_source"), U("") };
+
+            // connection_activation_concurrency [node]: maximum number of activations for which the callbacks may be run concurrently, with the model unlocked, when several are due at once
+            // (1, the default, means the callbacks are run sequentially, with the model locked)
+            const web::json::field_as_integer_or connection_activation_concurrency{ U("connection_activation_concurrency"), 1 };
+
+            // events_conflation_interval_ms [node]: minimum interval in milliseconds between state messages on each Events WebSocket API connection for each source which
+            // has opted in to conflation (see nmos::experimental::fields::conflate), so that only the latest state is sent
+            const web::json::field_as_integer_or events_conflation_interval_ms{ U("events_conflation_interval_ms"), 100 };
+
             // proxy_map [registry, node]: mapping between the port numbers to which the client connects, and the port numbers on which the server should listen, if different
             // for use with a reverse proxy; each element of the array is an object like { "client_port": 80, "server_port": 8080 }
             const web::json::field_as_value_or proxy_map{ U("proxy_map"), web::json::value::array() };
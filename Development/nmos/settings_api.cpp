@@ -9,6 +9,61 @@ namespace nmos
 {
     namespace experimental
     {
+        namespace details
+        {
+            web::json::value make_lock_duration_histogram_json(const duration_histogram& histogram)
+            {
+                using web::json::value;
+                using web::json::value_of;
+
+                auto buckets = value::array();
+                std::uint64_t cumulative_count = 0;
+                for (size_t bucket = 0; bucket <= duration_histogram::bucket_count; ++bucket)
+                {
+                    cumulative_count += histogram.bucket(bucket);
+                    web::json::push_back(buckets, value_of({
+                        { U("le_us"), duration_histogram::bucket_count != bucket ? value(1e6 * duration_histogram::bucket_upper_bound(bucket)) : value::null() },
+                        { U("count"), cumulative_count }
+                    }));
+                }
+
+                return value_of({
+                    { U("count"), histogram.count() },
+                    { U("sum_us"), 1e6 * histogram.sum() },
+                    { U("buckets"), buckets }
+                });
+            }
+
+            web::json::value make_mutex_statistics_json(const nmos::mutex& mutex)
+            {
+                using web::json::value;
+                using web::json::value_of;
+
+                static const utility::string_t kinds[lock_kind_count] = { U("shared"), U("upgrade"), U("exclusive") };
+
+                auto categories = value::object();
+                for (const auto& category : mutex.statistics())
+                {
+                    auto& category_json = categories[utility::s2us(category.first.empty() ? std::string("other") : category.first)] = value::object();
+                    for (int kind = 0; kind < lock_kind_count; ++kind)
+                    {
+                        const auto& statistics = category.second[kind];
+                        if (0 == statistics.wait.count() && 0 == statistics.hold.count()) continue;
+
+                        category_json[kinds[kind]] = value_of({
+                            { U("wait"), make_lock_duration_histogram_json(statistics.wait) },
+                            { U("hold"), make_lock_duration_histogram_json(statistics.hold) }
+                        });
+                    }
+                }
+
+                return value_of({
+                    { U("enabled"), mutex.statistics_enabled() },
+                    { U("categories"), categories }
+                });
+            }
+        }
+
         web::http::experimental::listener::api_router make_settings_api(nmos::base_model& model, nmos::experimental::log_model& log_model, slog::base_gate& gate_)
         {
             using namespace web::http::experimental::listener::api_router_using_declarations;
@@ -23,7 +78,7 @@ namespace nmos
 
             settings_api.support(U("/settings/?"), methods::GET, [](http_request req, http_response res, const string_t&, const route_parameters&)
             {
-                set_reply(res, status_codes::OK, nmos::make_sub_routes_body({ U("all/") }, req, res));
+                set_reply(res, status_codes::OK, nmos::make_sub_routes_body({ U("all/"), U("mutex/") }, req, res));
                 return pplx::task_from_result(true);
             });
 
@@ -57,6 +112,9 @@ namespace nmos
                     // that can be read by logging statements without locking the mutex protecting the settings
                     log_model.level = nmos::fields::logging_level(log_model.settings);
 
+                    // similarly, recording statistics for the model mutex can be enabled or disabled at run-time
+                    model.mutex.enable_statistics(nmos::experimental::fields::mutex_statistics(model.settings));
+
                     // notify anyone who cares...
                     model.notify();
 
@@ -66,6 +124,22 @@ namespace nmos
                 });
             });
 
+            // acquire-wait and hold-duration statistics for the model mutex (when enabled by the mutex_statistics setting)
+            // these are read without locking the model mutex itself
+
+            settings_api.support(U("/settings/mutex/?"), methods::GET, [&model](http_request, http_response res, const string_t&, const route_parameters&)
+            {
+                set_reply(res, status_codes::OK, details::make_mutex_statistics_json(model.mutex));
+                return pplx::task_from_result(true);
+            });
+
+            settings_api.support(U("/settings/mutex/?"), methods::DEL, [&model](http_request, http_response res, const string_t&, const route_parameters&)
+            {
+                model.mutex.reset_statistics();
+                set_reply(res, status_codes::NoContent);
+                return pplx::task_from_result(true);
+            });
+
             return settings_api;
         }
     }
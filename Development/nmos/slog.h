@@ -37,6 +37,8 @@ namespace nmos
         // categories that identify threads of execution
         const category node_behaviour{ "node_behaviour" };
         const category registration_expiry{ "registration_expiry" };
+        const category registry_persistence{ "registry_persistence" };
+        const category registry_replication{ "registry_replication" };
         const category send_query_ws_events{ "send_query_ws_events" };
         const category receive_query_ws_events{ "receive_query_ws_events" };
         const category send_events_ws_messages{ "send_events_ws_messages" };
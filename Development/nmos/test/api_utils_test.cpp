@@ -1,7 +1,13 @@
 // The first "test" is of course whether the header compiles standalone
 #include "nmos/api_utils.h"
 
+#ifdef NMOS_CPP_TEST_BENCHMARKS
+#include <chrono>
+#include <iostream>
+#endif
 #include "bst/test/test.h"
+#include "cpprest/http_compression.h"
+#include "nmos/tai.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 BST_TEST_CASE(testAddCorsPreflightHeaders)
@@ -97,3 +103,146 @@ BST_TEST_CASE(testMakeErrorResponseBody)
     }
     // successful status code perhaps ought to throw?
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testNegotiateContentEncoding)
+{
+    // compression is only available when the C++ REST SDK was built with zlib
+    if (!web::http::compression::builtin::supported()) return;
+
+    const std::vector<std::pair<utility::string_t, utility::string_t>> cases
+    {
+        { U(""), U("") },
+        { U("identity"), U("") },
+        { U("gzip"), U("gzip") },
+        { U("deflate"), U("deflate") },
+        { U("gzip, deflate"), U("gzip") },
+        { U("deflate, gzip"), U("gzip") },
+        { U("gzip;q=0.5, deflate"), U("deflate") },
+        { U("GZIP ; Q=0.5 , deflate;q=0.4"), U("gzip") },
+        { U("gzip;q=0, deflate;q=0"), U("") },
+        { U("br, *;q=0.1"), U("gzip") },
+        { U("*;q=0"), U("") }
+    };
+    for (const auto& c : cases)
+    {
+        web::http::http_request req;
+        if (!c.first.empty()) req.headers().add(web::http::header_names::accept_encoding, c.first);
+        BST_REQUIRE_EQUAL(c.second, nmos::experimental::negotiate_content_encoding(req));
+    }
+}
+
+namespace
+{
+    std::vector<uint8_t> decompress(const utility::string_t& content_encoding, const std::vector<uint8_t>& compressed)
+    {
+        auto decompressor = web::http::compression::builtin::make_decompressor(content_encoding);
+        std::vector<uint8_t> result;
+        size_t processed = 0;
+        bool done = false;
+        while (!done)
+        {
+            const size_t chunk = 4096;
+            const auto produced = result.size();
+            result.resize(produced + chunk);
+            const auto op = decompressor->decompress(compressed.data() + processed, compressed.size() - processed, result.data() + produced, chunk, web::http::compression::operation_hint::is_last).get();
+            processed += op.input_bytes_processed;
+            result.resize(produced + op.output_bytes_produced);
+            done = op.done || (0 == op.input_bytes_processed && 0 == op.output_bytes_produced);
+        }
+        return result;
+    }
+
+    // a body similar to a Query API response for a page of senders
+    std::string make_test_senders_body()
+    {
+        std::string body = "[";
+        for (int i = 0; i < 1000; ++i)
+        {
+            if (0 != i) body += ",";
+            body += R"({"id":"6f4e3f7a-1b2c-4d5e-8f90-)" + std::to_string(100000000000 + i) + R"(","version":"1577836800:)" + std::to_string(i) + R"(","label":"Sender )" + std::to_string(i) + R"(","description":"","tags":{},)"
+                R"("flow_id":"0a1b2c3d-4e5f-4a6b-8c7d-)" + std::to_string(200000000000 + i) + R"(","transport":"urn:x-nmos:transport:rtp.mcast","device_id":"9f8e7d6c-5b4a-4392-8170-000000000001",)"
+                R"("manifest_href":"http://192.0.2.1:3212/x-nmos/connection/v1.1/single/senders/)" + std::to_string(i) + R"(/transportfile/","interface_bindings":["eth0","eth1"],)"
+                R"("subscription":{"receiver_id":null,"active":false}})";
+        }
+        body += "]";
+        return body;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testCompressRoundTrip)
+{
+    if (!web::http::compression::builtin::supported()) return;
+
+    const auto body = make_test_senders_body();
+
+    // each supported content coding should reduce the size of a typical body, and be losslessly decompressed
+    for (const auto& content_encoding : { utility::string_t(U("gzip")), utility::string_t(U("deflate")) })
+    {
+        if (!web::http::compression::builtin::algorithm::supported(content_encoding)) continue;
+
+        const auto compressed = nmos::experimental::compress(content_encoding, (const uint8_t*)body.data(), body.size());
+        BST_REQUIRE_LT(compressed.size(), body.size());
+        const auto decompressed = decompress(content_encoding, compressed);
+        BST_REQUIRE(std::string(decompressed.begin(), decompressed.end()) == body);
+    }
+}
+
+#ifdef NMOS_CPP_TEST_BENCHMARKS
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testCompressBenchmark)
+{
+    // a simple benchmark of the trade-off between CPU time and bytes on the wire for each supported content coding
+    // (only built when NMOS_CPP_TEST_BENCHMARKS is defined, see cmake/NmosCppTest.cmake)
+
+    if (!web::http::compression::builtin::supported()) return;
+
+    const auto body = make_test_senders_body();
+
+    for (const auto& content_encoding : { utility::string_t(U("gzip")), utility::string_t(U("deflate")) })
+    {
+        if (!web::http::compression::builtin::algorithm::supported(content_encoding)) continue;
+
+        const int iterations = 100;
+        std::vector<uint8_t> compressed;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            compressed = nmos::experimental::compress(content_encoding, (const uint8_t*)body.data(), body.size());
+        }
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start) / iterations;
+
+        BST_REQUIRE_LT(compressed.size(), body.size());
+
+        std::cout << utility::us2s(content_encoding) << ": " << body.size() << " bytes to " << compressed.size() << " bytes in " << elapsed.count() << " us" << std::endl;
+    }
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testIsNotModified)
+{
+    const auto etag = nmos::experimental::make_etag(nmos::tai{ 1577836800, 42 });
+    BST_REQUIRE_EQUAL(U("\"1577836800:42\""), etag);
+
+    const std::vector<std::pair<utility::string_t, bool>> cases
+    {
+        { U(""), false },
+        { U("\"1577836800:42\""), true },
+        { U("W/\"1577836800:42\""), true },
+        { U("\"1577836800:42-gzip\""), true },
+        { U("\"1577836800:43\""), false },
+        { U("\"1577836800:41\", \"1577836800:42\""), true },
+        { U("*"), true }
+    };
+    for (const auto& c : cases)
+    {
+        web::http::http_request req;
+        if (!c.first.empty()) req.headers().add(web::http::header_names::if_none_match, c.first);
+        BST_REQUIRE_EQUAL(c.second, nmos::experimental::is_not_modified(req, etag));
+    }
+
+    // page entity-tags depend on the paging parameters and the number of resources
+    BST_REQUIRE(nmos::experimental::make_etag(nmos::tai{ 1, 0 }, nmos::tai{ 2, 0 }, 10) != nmos::experimental::make_etag(nmos::tai{ 1, 0 }, nmos::tai{ 2, 0 }, 9));
+}
@@ -0,0 +1,79 @@
+// The first "test" is of course whether the header compiles standalone
+#include "nmos/events_subscribers.h"
+
+#include "bst/test/test.h"
+#include "nmos/events_resources.h"
+#include "nmos/model.h"
+#include "nmos/test/test_resources.h"
+
+namespace
+{
+    void set_test_state(nmos::node_model& model, const nmos::id& source_id, bool value)
+    {
+        nmos::modify_resource(model.events_resources, source_id, [&](nmos::resource& resource)
+        {
+            nmos::fields::endpoint_state(resource.data) = nmos::make_events_boolean_state({ source_id }, value);
+        });
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testEventsSubscribersDispatchEveryChange)
+{
+    nmos::node_model model;
+
+    const nmos::id source_id{ U("source") };
+    const nmos::id other_source_id{ U("other") };
+    const nmos::id grain_id{ U("grain") };
+
+    nmos::insert_resource(model.events_resources, nmos::make_events_source(source_id, nmos::make_events_boolean_state({ source_id }, false), nmos::make_events_boolean_type()));
+    nmos::insert_resource(model.events_resources, nmos::make_events_source(other_source_id, nmos::make_events_boolean_state({ other_source_id }, false), nmos::make_events_boolean_type()));
+    nmos::insert_resource(model.events_resources, nmos::test::make_grain(grain_id));
+
+    model.events_subscribers.subscribe(grain_id, { source_id });
+
+    // every state change of the subscribed source is appended to the grain, in order, even when there are several before it is sent
+    set_test_state(model, source_id, true);
+    set_test_state(model, source_id, false);
+    // but not those of other sources
+    set_test_state(model, other_source_id, true);
+
+    const auto& events = nmos::fields::message_grain_data(nmos::find_resource(model.events_resources, grain_id)->data);
+    BST_REQUIRE_EQUAL(2, events.size());
+    BST_REQUIRE_EQUAL(true, nmos::fields::endpoint_state(events.at(0).at(U("post"))).at(U("payload")).at(U("value")).as_bool());
+    BST_REQUIRE_EQUAL(false, nmos::fields::endpoint_state(events.at(1).at(U("post"))).at(U("payload")).at(U("value")).as_bool());
+
+    // no further changes are dispatched once the connection has unsubscribed
+    model.events_subscribers.unsubscribe(grain_id);
+    set_test_state(model, source_id, true);
+    BST_REQUIRE_EQUAL(2, nmos::fields::message_grain_data(nmos::find_resource(model.events_resources, grain_id)->data).size());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testEventsSubscribersConflate)
+{
+    nmos::node_model model;
+    model.settings[nmos::experimental::fields::events_conflation_interval_ms] = web::json::value::number(60000);
+
+    const nmos::id source_id{ U("source") };
+    const nmos::id grain_id{ U("grain") };
+
+    auto source = nmos::make_events_source(source_id, nmos::make_events_boolean_state({ source_id }, false), nmos::make_events_boolean_type());
+    source.data[nmos::experimental::fields::conflate] = web::json::value::boolean(true);
+    nmos::insert_resource(model.events_resources, std::move(source));
+    nmos::insert_resource(model.events_resources, nmos::test::make_grain(grain_id));
+
+    model.events_subscribers.subscribe(grain_id, { source_id });
+
+    // the first change is sent straight away, and only the latest of the subsequent changes is kept until the interval has passed
+    set_test_state(model, source_id, true);
+    set_test_state(model, source_id, false);
+    set_test_state(model, source_id, true);
+
+    BST_REQUIRE_EQUAL(1, nmos::fields::message_grain_data(nmos::find_resource(model.events_resources, grain_id)->data).size());
+
+    const auto& conflated_states = model.events_subscribers.conflated_states();
+    BST_REQUIRE_EQUAL(1, conflated_states.size());
+    const auto& conflated_state = conflated_states.begin()->second;
+    BST_REQUIRE_EQUAL(true, nmos::fields::endpoint_state(conflated_state.event.at(U("post"))).at(U("payload")).at(U("value")).as_bool());
+}
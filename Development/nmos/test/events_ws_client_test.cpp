@@ -0,0 +1,142 @@
+// The first "test" is of course whether the header compiles standalone
+#include "nmos/events_ws_client.h"
+
+#include <map>
+#include <mutex>
+#ifdef NMOS_CPP_TEST_BENCHMARKS
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#endif
+#include "bst/test/test.h"
+#include "cpprest/basic_utils.h"
+#include "nmos/events_resources.h"
+#include "slog/all_in_one.h"
+
+namespace
+{
+    struct nolog_gate : slog::base_gate
+    {
+        bool pertinent(slog::severity) const override { return false; }
+        void log(const slog::log_message&) const override {}
+    };
+
+    std::vector<nmos::id> make_test_source_ids(int source_count)
+    {
+        std::vector<nmos::id> source_ids;
+        for (int source = 0; source < source_count; ++source)
+        {
+            source_ids.push_back(U("source-") + utility::s2us(std::to_string(source)));
+        }
+        return source_ids;
+    }
+
+    // messages from each source in turn, each state with the message number as its payload, followed by a health message
+    std::vector<std::string> make_test_messages(const std::vector<nmos::id>& source_ids, int message_count)
+    {
+        std::vector<std::string> messages;
+        for (int i = 0; i < message_count; ++i)
+        {
+            for (const auto& source_id : source_ids)
+            {
+                messages.push_back(utility::conversions::to_utf8string(nmos::make_events_number_state({ source_id }, i).serialize()));
+            }
+        }
+        messages.push_back(utility::conversions::to_utf8string(nmos::make_events_health_command().serialize()));
+        return messages;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testEventsWsMessageRouterOrdering)
+{
+    // check that messages received on a single connection are routed to the per-source handlers, or the default handler,
+    // and that messages from each source are handled in order, whether the handlers are called synchronously or asynchronously
+
+    const web::uri connection_uri(U("ws://127.0.0.1:3217/"));
+    const int source_count = 10;
+    const int message_count = 100;
+
+    const auto source_ids = make_test_source_ids(source_count);
+    const auto messages = make_test_messages(source_ids, message_count);
+
+    for (const bool asynchronous : { false, true })
+    {
+        nolog_gate gate;
+        nmos::details::events_ws_message_router router(gate);
+        router.set_asynchronous(asynchronous);
+
+        std::mutex mutex;
+        int default_count = 0;
+        std::map<nmos::id, int> expected_values;
+        bool in_order = true;
+
+        router.set_message_handler([&](const web::uri&, const web::json::value&)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++default_count;
+        });
+        for (const auto& source_id : source_ids)
+        {
+            router.set_source_message_handler(source_id, [&, source_id](const web::uri&, const web::json::value& message)
+            {
+                const auto value = (int)message.at(U("payload")).at(U("value")).as_double();
+                std::lock_guard<std::mutex> lock(mutex);
+                if (expected_values[source_id]++ != value) in_order = false;
+            });
+        }
+
+        for (const auto& message : messages)
+        {
+            router.route(connection_uri, message);
+        }
+        router.wait();
+
+        BST_REQUIRE(in_order);
+        BST_REQUIRE_EQUAL(1, default_count);
+        for (const auto& source_id : source_ids)
+        {
+            BST_REQUIRE_EQUAL(message_count, expected_values[source_id]);
+        }
+    }
+}
+
+#ifdef NMOS_CPP_TEST_BENCHMARKS
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testEventsWsMessageRouterThroughput)
+{
+    // a simple benchmark of the sustained rate at which messages received on a single connection can be parsed and routed to per-source handlers
+    // (only built when NMOS_CPP_TEST_BENCHMARKS is defined, see cmake/NmosCppTest.cmake)
+
+    const web::uri connection_uri(U("ws://127.0.0.1:3217/"));
+    const auto source_ids = make_test_source_ids(10);
+    const auto messages = make_test_messages(source_ids, 10000);
+
+    for (const bool asynchronous : { false, true })
+    {
+        nolog_gate gate;
+        nmos::details::events_ws_message_router router(gate);
+        router.set_asynchronous(asynchronous);
+
+        std::atomic<std::size_t> handled{ 0 };
+        router.set_message_handler([&](const web::uri&, const web::json::value&) { ++handled; });
+        for (const auto& source_id : source_ids)
+        {
+            router.set_source_message_handler(source_id, [&](const web::uri&, const web::json::value&) { ++handled; });
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto& message : messages)
+        {
+            router.route(connection_uri, message);
+        }
+        router.wait();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count();
+
+        BST_REQUIRE_EQUAL(messages.size(), handled.load());
+
+        std::cout << "Routed " << messages.size() << " messages " << (asynchronous ? "asynchronously" : "synchronously") << " in " << elapsed << " seconds"
+            << " (" << (0 != elapsed ? messages.size() / elapsed : 0) << " per second)" << std::endl;
+    }
+}
+#endif
@@ -0,0 +1,126 @@
+// The first "test" is of course whether the header compiles standalone
+#include "nmos/model_transaction.h"
+
+#include <chrono>
+#include <thread>
+#include "bst/test/test.h"
+#include "nmos/json_fields.h"
+#include "nmos/node_resource.h"
+
+namespace
+{
+    // a thread which waits on the model condition, and records the number of node resources it sees each time it is woken
+    struct test_waiter
+    {
+        explicit test_waiter(nmos::node_model& model)
+            : model(model)
+            , waits(0)
+            , seen(0)
+            , done(false)
+            , thread([this] { run(); })
+        {
+        }
+
+        ~test_waiter()
+        {
+            {
+                auto lock = model.write_lock();
+                done = true;
+            }
+            model.notify();
+            thread.join();
+        }
+
+        // wait until the thread has started waiting the specified number of times, i.e. has been woken one fewer times
+        bool wait_for_waits(std::size_t count, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000))
+        {
+            const auto deadline = std::chrono::steady_clock::now() + timeout;
+            for (;;)
+            {
+                {
+                    auto lock = model.write_lock();
+                    if (count <= waits) return true;
+                }
+                if (deadline < std::chrono::steady_clock::now()) return false;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        std::size_t seen_resources()
+        {
+            auto lock = model.write_lock();
+            return seen;
+        }
+
+    private:
+        void run()
+        {
+            auto lock = model.write_lock();
+            while (!done)
+            {
+                ++waits;
+                model.wait(lock);
+                if (done) return;
+                seen = model.node_resources.size();
+            }
+        }
+
+        nmos::node_model& model;
+        std::size_t waits;
+        std::size_t seen;
+        bool done;
+        std::thread thread;
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testNodeModelTransaction)
+{
+    nmos::node_model model;
+    test_waiter waiter(model);
+    BST_REQUIRE(waiter.wait_for_waits(1));
+
+    // the waiting thread is notified once, when the transaction is committed, and sees all the changes
+    {
+        nmos::experimental::node_model_transaction transaction(model);
+        BST_REQUIRE(transaction.insert(model.node_resources, nmos::make_node(U("a"), model.settings)));
+        BST_REQUIRE(transaction.insert(model.node_resources, nmos::make_node(U("b"), model.settings)));
+        BST_REQUIRE(transaction.modify(model.node_resources, U("a"), [](nmos::resource& resource)
+        {
+            resource.data[nmos::fields::label] = web::json::value::string(U("a"));
+        }));
+        BST_REQUIRE_EQUAL(3, transaction.size());
+
+        transaction.commit();
+        BST_REQUIRE_EQUAL(0, transaction.size());
+        // nothing is left to be committed when the transaction is destroyed
+    }
+    BST_REQUIRE(waiter.wait_for_waits(2));
+    BST_REQUIRE_EQUAL(2, waiter.seen_resources());
+
+    // failed changes are not counted, so there is nothing to notify
+    {
+        nmos::experimental::node_model_transaction transaction(model);
+        BST_REQUIRE(!transaction.insert(model.node_resources, nmos::make_node(U("a"), model.settings)));
+        BST_REQUIRE(!transaction.modify(model.node_resources, U("missing"), [](nmos::resource&) {}));
+        BST_REQUIRE(!transaction.erase(model.node_resources, U("missing")));
+        BST_REQUIRE_EQUAL(0, transaction.size());
+
+        transaction.commit();
+    }
+    BST_REQUIRE(!waiter.wait_for_waits(3, std::chrono::milliseconds(100)));
+
+    // a transaction which is not explicitly committed is committed when it is destroyed, while the caller's lock is still held
+    {
+        auto lock = model.write_lock();
+        nmos::experimental::node_model_transaction transaction(model, lock);
+        BST_REQUIRE(transaction.erase(model.node_resources, U("b")));
+        BST_REQUIRE_EQUAL(1, transaction.size());
+    }
+    BST_REQUIRE(waiter.wait_for_waits(3));
+    BST_REQUIRE_EQUAL(1, waiter.seen_resources());
+
+    // the caller's lock must already be locked
+    nmos::write_lock unlocked(model.mutex, std::defer_lock);
+    BST_REQUIRE_THROW(nmos::experimental::node_model_transaction{ model, unlocked }, std::logic_error);
+}
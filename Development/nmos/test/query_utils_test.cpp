@@ -0,0 +1,126 @@
+// The first "test" is of course whether the header compiles standalone
+#include "nmos/query_utils.h"
+
+#include "bst/test/test.h"
+#include "cpprest/json_utils.h"
+#include "nmos/is04_versions.h"
+#include "nmos/resources.h"
+#include "nmos/test/test_resources.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testResourceQueryAncestry)
+{
+    // query parameters are strings, including query.ancestry_generations
+    nmos::resource_query match(nmos::is04_versions::v1_3, U("/flows"), web::json::value_of({
+        { U("query.ancestry_id"), U("parent") },
+        { U("query.ancestry_type"), U("children") },
+        { U("query.ancestry_generations"), U("1") }
+    }));
+    BST_REQUIRE_EQUAL(utility::string_t(U("parent")), match.ancestry_id);
+    BST_REQUIRE_EQUAL(utility::string_t(U("children")), match.ancestry_type);
+    BST_REQUIRE_EQUAL(1, match.ancestry_generations);
+    // the ancestry query parameters are not part of the basic query
+    BST_REQUIRE(!match.basic_query.has_field(U("query")));
+
+    nmos::resources resources;
+    nmos::insert_resource(resources, nmos::test::make_flow(U("parent"), {}));
+    nmos::insert_resource(resources, nmos::test::make_flow(U("child"), { U("parent") }));
+    nmos::insert_resource(resources, nmos::test::make_flow(U("grandchild"), { U("child") }));
+
+    match.resolve_ancestry(resources);
+    BST_REQUIRE(match(*nmos::find_resource(resources, U("child"))));
+    BST_REQUIRE(!match(*nmos::find_resource(resources, U("grandchild"))));
+    BST_REQUIRE(!match(*nmos::find_resource(resources, U("parent"))));
+
+    // all generations by default
+    nmos::resource_query all(nmos::is04_versions::v1_3, U("/flows"), web::json::value_of({
+        { U("query.ancestry_id"), U("grandchild") },
+        { U("query.ancestry_type"), U("parents") }
+    }));
+    BST_REQUIRE_EQUAL(0, all.ancestry_generations);
+    all.resolve_ancestry(resources);
+    BST_REQUIRE((std::set<nmos::id>{ U("child"), U("parent") } == all.ancestry));
+
+    BST_REQUIRE_THROW(nmos::resource_query(nmos::is04_versions::v1_3, U("/flows"), web::json::value_of({ { U("query.ancestry_id"), U("parent") }, { U("query.ancestry_type"), U("siblings") } })), web::json::json_exception);
+    BST_REQUIRE_THROW(nmos::resource_query(nmos::is04_versions::v1_3, U("/flows"), web::json::value_of({ { U("query.ancestry_id"), U("parent") } })), web::json::json_exception);
+    for (const auto& generations : { U("-1"), U("1.5"), U("\"1\""), U("x") })
+    {
+        BST_REQUIRE_THROW(nmos::resource_query(nmos::is04_versions::v1_3, U("/flows"), web::json::value_of({ { U("query.ancestry_id"), U("parent") }, { U("query.ancestry_type"), U("children") }, { U("query.ancestry_generations"), generations } })), web::json::json_exception);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testParseFields)
+{
+    // empty key paths are ignored
+    const auto fields = nmos::experimental::parse_fields(U("id,,caps.media_types"));
+    BST_REQUIRE_EQUAL(2, fields.size());
+    BST_REQUIRE((std::vector<utility::string_t>{ U("id") } == fields[0]));
+    BST_REQUIRE((std::vector<utility::string_t>{ U("caps"), U("media_types") } == fields[1]));
+
+    BST_REQUIRE(nmos::experimental::parse_fields(U("")).empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testProject)
+{
+    const auto value = web::json::value_of({
+        { U("id"), U("receiver") },
+        { U("label"), U("") },
+        { U("caps"), web::json::value_of({
+            { U("media_types"), web::json::value_of({ U("video/raw") }) },
+            { U("event_types"), web::json::value_of({ U("boolean") }) }
+        }) }
+    });
+
+    // top-level and nested key paths
+    const auto projected = nmos::experimental::project(value, nmos::experimental::parse_fields(U("id,caps.media_types")));
+    BST_REQUIRE_EQUAL(web::json::value_of({
+        { U("id"), U("receiver") },
+        { U("caps"), web::json::value_of({
+            { U("media_types"), web::json::value_of({ U("video/raw") }) }
+        }) }
+    }), projected);
+
+    // key paths which are not present are omitted, without leaving an empty object behind
+    const auto missing = nmos::experimental::project(value, nmos::experimental::parse_fields(U("id,caps.formats,tags.x,label.x")));
+    BST_REQUIRE_EQUAL(web::json::value_of({ { U("id"), U("receiver") } }), missing);
+
+    // a whole object, and a key path within it, in either order
+    BST_REQUIRE_EQUAL(value.at(U("caps")), nmos::experimental::project(value, nmos::experimental::parse_fields(U("caps,caps.media_types"))).at(U("caps")));
+    BST_REQUIRE_EQUAL(value.at(U("caps")), nmos::experimental::project(value, nmos::experimental::parse_fields(U("caps.media_types,caps"))).at(U("caps")));
+
+    // null, e.g. the pre or post of a resource event for an insertion or erasure, is left alone
+    BST_REQUIRE(nmos::experimental::project(web::json::value::null(), nmos::experimental::parse_fields(U("id"))).is_null());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testResourceQueryFields)
+{
+    nmos::resources resources;
+    nmos::insert_resource(resources, nmos::test::make_flow(U("flow"), { U("parent") }));
+    const auto& flow = *nmos::find_resource(resources, U("flow"));
+
+    // by default, the whole resource is returned
+    nmos::resource_query all(nmos::is04_versions::v1_3, U("/flows"), web::json::value::object());
+    BST_REQUIRE(all.fields.empty());
+    BST_REQUIRE_EQUAL(flow.data, all.downgrade(flow));
+
+    // query.fields is not part of the basic query, so does not affect which resources match
+    nmos::resource_query match(nmos::is04_versions::v1_3, U("/flows"), web::json::value_of({
+        { U("query.fields"), U("id,parents,tags.x") }
+    }));
+    BST_REQUIRE_EQUAL(3, match.fields.size());
+    BST_REQUIRE(!match.basic_query.has_field(U("query")));
+    BST_REQUIRE(match(flow));
+
+    const auto expected = web::json::value_of({
+        { U("id"), U("flow") },
+        { U("parents"), web::json::value_of({ U("parent") }) }
+    });
+    BST_REQUIRE_EQUAL(expected, match.downgrade(flow));
+
+    // the serialized projection isn't taken from the resource's cached serialization of the whole resource
+    BST_REQUIRE_EQUAL(expected, web::json::value::parse(*match.serialize_downgrade(flow)));
+    BST_REQUIRE_EQUAL(flow.data, web::json::value::parse(*all.serialize_downgrade(flow)));
+}
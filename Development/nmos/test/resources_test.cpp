@@ -0,0 +1,42 @@
+// The first "test" is of course whether the header compiles standalone
+#include "nmos/resources.h"
+
+#include "bst/test/test.h"
+#include "cpprest/json_utils.h"
+#include "nmos/json_fields.h"
+#include "nmos/test/test_resources.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testGetAncestry)
+{
+    nmos::resources resources;
+
+    // children are inserted before their parents, without joining sub-resources, but are still tracked
+    nmos::insert_resource(resources, nmos::test::make_flow(U("grandchild"), { U("child") }));
+    nmos::insert_resource(resources, nmos::test::make_flow(U("child"), { U("parent") }));
+    nmos::insert_resource(resources, nmos::test::make_flow(U("parent"), {}));
+
+    BST_REQUIRE_EQUAL(1, nmos::get_child_resources(resources, U("parent")).size());
+
+    BST_REQUIRE((std::set<nmos::id>{ U("child"), U("grandchild") } == nmos::get_ancestry(resources, U("parent"), U("children"))));
+    BST_REQUIRE((std::set<nmos::id>{ U("child") } == nmos::get_ancestry(resources, U("parent"), U("children"), 1)));
+    BST_REQUIRE((std::set<nmos::id>{ U("child"), U("parent") } == nmos::get_ancestry(resources, U("grandchild"), U("parents"))));
+    BST_REQUIRE((std::set<nmos::id>{ U("child") } == nmos::get_ancestry(resources, U("grandchild"), U("parents"), 1)));
+
+    // modifying the parents moves the resource to its new parent
+    nmos::modify_resource(resources, U("grandchild"), [](nmos::resource& resource)
+    {
+        resource.data[nmos::fields::parents] = web::json::value_from_elements(std::vector<nmos::id>{ U("parent") });
+    });
+    BST_REQUIRE((std::set<nmos::id>{ U("child"), U("grandchild") } == nmos::get_ancestry(resources, U("parent"), U("children"), 1)));
+    BST_REQUIRE(nmos::get_child_resources(resources, U("child")).empty());
+
+    // erased resources are no longer children, and only extant resources are included
+    nmos::erase_resource(resources, U("child"));
+    BST_REQUIRE((std::set<nmos::id>{ U("grandchild") } == nmos::get_ancestry(resources, U("parent"), U("children"))));
+
+    // parents which have not been inserted are still tracked, but not included
+    nmos::insert_resource(resources, nmos::test::make_flow(U("orphan"), { U("missing") }));
+    BST_REQUIRE_EQUAL(1, nmos::get_child_resources(resources, U("missing")).size());
+    BST_REQUIRE(nmos::get_ancestry(resources, U("orphan"), U("parents")).empty());
+}
@@ -0,0 +1,35 @@
+#ifndef NMOS_TEST_TEST_RESOURCES_H
+#define NMOS_TEST_TEST_RESOURCES_H
+
+#include "cpprest/json_utils.h"
+#include "nmos/is07_versions.h"
+#include "nmos/json_fields.h"
+#include "nmos/node_resources.h"
+#include "nmos/query_utils.h" // for nmos::details::make_grain
+
+// Resource fixtures shared by the nmos tests, made by the usual resource factories wherever possible
+namespace nmos
+{
+    namespace test
+    {
+        // a flow of an arbitrary source and device, with the specified parents
+        inline nmos::resource make_flow(const nmos::id& id, const std::vector<nmos::id>& parents)
+        {
+            auto resource = nmos::make_flow(id, U("source"), U("device"), {}, web::json::value::object());
+            resource.data[nmos::fields::parents] = web::json::value_from_elements(parents);
+            return resource;
+        }
+
+        // an IS-07 Events WebSocket subscription grain, which has no resource factory of its own (cf. nmos::experimental::make_events_ws_api)
+        inline nmos::resource make_grain(const nmos::id& id)
+        {
+            web::json::value data;
+            data[nmos::fields::id] = web::json::value::string(id);
+            data[nmos::fields::message] = nmos::details::make_grain({}, {}, U("/sources/"));
+            nmos::fields::message_grain_data(data) = web::json::value::array();
+            return{ nmos::is07_versions::v1_0, nmos::types::grain, data, false };
+        }
+    }
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include "sdp/sdp_grammar.h"
 #include "sdp/sdp.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include "bst/regex.h"
 #include "cpprest/basic_utils.h"
@@ -790,23 +791,42 @@ namespace sdp
         return result.str();
     }
 
-    web::json::value read_equals_value(std::istream& is, const grammar::converter& value_converter)
+    // a cursor over the contiguous buffer of a complete SDP session description, which avoids the overhead of std::istream
+    // and reuses a single buffer for the value of each line that is passed to the converter
+    struct description_reader
     {
-        if ('=' != is.get()) throw sdp_parse_error("expected '='");
+        description_reader(const char* first, const char* last) : pos(first), end(last) {}
 
-        std::string line;
-        std::getline(is, line, '\n');
-        if ('\r' == line.back()) line.pop_back();
+        // the type of the next line, or EOF
+        int peek() const { return end != pos ? std::char_traits<char>::to_int_type(*pos) : std::char_traits<char>::eof(); }
+        int get() { return end != pos ? std::char_traits<char>::to_int_type(*pos++) : std::char_traits<char>::eof(); }
+        bool eof() const { return end == pos; }
+
+        const char* pos;
+        const char* end;
+        std::string value;
+    };
+
+    web::json::value read_equals_value(description_reader& reader, const grammar::converter& value_converter)
+    {
+        if ('=' != reader.get()) throw sdp_parse_error("expected '='");
+
+        const char* eol = std::find(reader.pos, reader.end, '\n');
+        const char* last = eol;
+        if (reader.pos != last && '\r' == *(last - 1)) --last;
         // else throw sdp_parse_error("expected CRLF");
 
-        return value_converter.parse(line);
+        reader.value.assign(reader.pos, last);
+        reader.pos = reader.end != eol ? eol + 1 : eol;
+
+        return value_converter.parse(reader.value);
     }
 
-    void read_line(std::istream& is, int& line_number, web::json::value& line, const grammar::line& grammar)
+    void read_line(description_reader& reader, int& line_number, web::json::value& line, const grammar::line& grammar)
     {
         if (grammar.list)
         {
-            const auto peek_type = is.peek();
+            const auto peek_type = reader.peek();
 
             // if required, must be correct type
             const bool valid = !grammar.required || grammar.type == peek_type;
@@ -816,30 +836,30 @@ namespace sdp
             auto lines = web::json::value::array();
             do
             {
-                is.get();
-                web::json::push_back(lines, read_equals_value(is, grammar.value_converter));
+                reader.get();
+                web::json::push_back(lines, read_equals_value(reader, grammar.value_converter));
                 ++line_number;
-            } while (grammar.type == is.peek());
+            } while (grammar.type == reader.peek());
             line = std::move(lines);
         }
         else
         {
-            const auto peek_type = is.peek();
+            const auto peek_type = reader.peek();
 
             // if required, must be correct type
             const bool valid = !grammar.required || grammar.type == peek_type;
             if (!valid) throw sdp_parse_error("expected a line for " + utility::us2s(grammar.name));
             if (grammar.type != peek_type) return;
 
-            is.get();
-            line = read_equals_value(is, grammar.value_converter);
+            reader.get();
+            line = read_equals_value(reader, grammar.value_converter);
             ++line_number;
         }
     }
 
-    void read_elements(std::istream& is, int& line_number, web::json::value& description, const std::vector<grammar::description::element>& elements);
+    void read_elements(description_reader& reader, int& line_number, web::json::value& description, const std::vector<grammar::description::element>& elements);
 
-    void read_description(std::istream& is, int& line_number, web::json::value& description, const grammar::description& grammar)
+    void read_description(description_reader& reader, int& line_number, web::json::value& description, const grammar::description& grammar)
     {
         // for simplicity of implementation, thankfully a description grammar always begins with a required line
         if (grammar.elements.empty()) throw std::logic_error("a description grammar  must not be empty");
@@ -848,7 +868,7 @@ namespace sdp
 
         if (grammar.list)
         {
-            const auto peek_type = is.peek();
+            const auto peek_type = reader.peek();
 
             // if required, must be correct type
             const bool valid = !grammar.required || sub_grammar->type == peek_type;
@@ -859,12 +879,12 @@ namespace sdp
             do
             {
                 web::json::push_back(description, web::json::value::object(sdp::grammar::keep_order));
-                read_elements(is, line_number, web::json::back(description), grammar.elements);
-            } while (sub_grammar->type == is.peek());
+                read_elements(reader, line_number, web::json::back(description), grammar.elements);
+            } while (sub_grammar->type == reader.peek());
         }
         else
         {
-            const auto peek_type = is.peek();
+            const auto peek_type = reader.peek();
 
             // if required, must be correct type
             const bool valid = !grammar.required || sub_grammar->type == peek_type;
@@ -872,24 +892,24 @@ namespace sdp
             if (sub_grammar->type != peek_type) return;
 
             description = web::json::value::object(sdp::grammar::keep_order);
-            read_elements(is, line_number, description, grammar.elements);
+            read_elements(reader, line_number, description, grammar.elements);
         }
     }
 
-    void read_elements(std::istream& is, int& line_number, web::json::value& description, const std::vector<grammar::description::element>& elements)
+    void read_elements(description_reader& reader, int& line_number, web::json::value& description, const std::vector<grammar::description::element>& elements)
     {
         for (auto& element : elements)
         {
             if (const sdp::grammar::line* sub_grammar = boost::get<sdp::grammar::line>(&element))
             {
                 web::json::value v;
-                read_line(is, line_number, v, *sub_grammar);
+                read_line(reader, line_number, v, *sub_grammar);
                 if (!v.is_null()) description[sub_grammar->name] = std::move(v);
             }
             else if (const sdp::grammar::description* sub_grammar = boost::get<sdp::grammar::description>(&element))
             {
                 web::json::value v;
-                read_description(is, line_number, v, *sub_grammar);
+                read_description(reader, line_number, v, *sub_grammar);
                 if (!v.is_null()) description[sub_grammar->name] = std::move(v);
             }
         }
@@ -898,13 +918,13 @@ namespace sdp
     // parse a complete SDP session description into its json representation, using the specified grammar
     web::json::value parse_session_description(const std::string& session_description, const grammar::description& grammar)
     {
-        std::istringstream is(session_description);
-        int line_number = 1; // could stash this in the stream?
+        description_reader reader(session_description.data(), session_description.data() + session_description.size());
+        int line_number = 1;
         try
         {
             web::json::value result;
-            read_description(is, line_number, result, grammar);
-            if (!is.eof()) throw sdp_parse_error("unexpected characters before end-of-file");
+            read_description(reader, line_number, result, grammar);
+            if (!reader.eof()) throw sdp_parse_error("unexpected characters before end-of-file");
             return result;
         }
         catch (const sdp_exception& e)
@@ -1,6 +1,10 @@
 // The first "test" is of course whether the header compiles standalone
 #include "sdp/sdp.h"
 
+#ifdef NMOS_CPP_TEST_BENCHMARKS
+#include <chrono>
+#include <iostream>
+#endif
 #include "bst/test/test.h"
 #include "sdp/json.h"
 
@@ -285,3 +289,109 @@ BST_TEST_CASE(testSdpParseErrors)
     // ... even if there's a complete valid line after it
     BST_REQUIRE_THROW(sdp::parse_session_description(enough + "\r\na=foo"), std::runtime_error);
 }
+
+namespace
+{
+    // a small corpus of ST 2110-20, ST 2110-30 and ST 2110-40 session descriptions
+    std::vector<std::string> make_test_corpus()
+    {
+        return{
+            // ST 2110-20 video, with ST 2022-7 duplicate legs
+            "v=0\r\n"
+            "o=- 3745911798 3745911798 IN IP4 192.168.9.142\r\n"
+            "s=Example Sender 1 (Video)\r\n"
+            "t=0 0\r\n"
+            "a=group:DUP PRIMARY SECONDARY\r\n"
+            "m=video 50020 RTP/AVP 96\r\n"
+            "c=IN IP4 239.22.142.1/32\r\n"
+            "a=ts-refclk:ptp=IEEE1588-2008:traceable\r\n"
+            "a=source-filter: incl IN IP4 239.22.142.1 192.168.9.142\r\n"
+            "a=rtpmap:96 raw/90000\r\n"
+            "a=fmtp:96 colorimetry=BT709; exactframerate=30000/1001; depth=10; TCS=SDR; sampling=YCbCr-4:2:2; width=1920; interlace; TP=2110TPN; PM=2110GPM; height=1080; SSN=ST2110-20:2017; \r\n"
+            "a=mediaclk:direct=0\r\n"
+            "a=mid:PRIMARY\r\n"
+            "m=video 50120 RTP/AVP 96\r\n"
+            "c=IN IP4 239.122.142.1/32\r\n"
+            "a=ts-refclk:ptp=IEEE1588-2008:traceable\r\n"
+            "a=source-filter: incl IN IP4 239.122.142.1 192.168.109.142\r\n"
+            "a=rtpmap:96 raw/90000\r\n"
+            "a=fmtp:96 colorimetry=BT709; exactframerate=30000/1001; depth=10; TCS=SDR; sampling=YCbCr-4:2:2; width=1920; interlace; TP=2110TPN; PM=2110GPM; height=1080; SSN=ST2110-20:2017; \r\n"
+            "a=mediaclk:direct=0\r\n"
+            "a=mid:SECONDARY\r\n",
+            // ST 2110-30 audio
+            "v=0\r\n"
+            "o=- 3745911799 3745911799 IN IP4 192.168.9.142\r\n"
+            "s=Example Sender 2 (Audio)\r\n"
+            "t=0 0\r\n"
+            "m=audio 50030 RTP/AVP 97\r\n"
+            "c=IN IP4 239.22.142.2/32\r\n"
+            "a=ts-refclk:ptp=IEEE1588-2008:traceable\r\n"
+            "a=source-filter: incl IN IP4 239.22.142.2 192.168.9.142\r\n"
+            "a=rtpmap:97 L24/48000/8\r\n"
+            "a=fmtp:97 channel-order=SMPTE2110.(SGRP,SGRP); \r\n"
+            "a=ptime:1\r\n"
+            "a=mediaclk:direct=0\r\n",
+            // ST 2110-40 ancillary data
+            "v=0\r\n"
+            "o=- 3745911800 3745911800 IN IP4 192.168.9.142\r\n"
+            "s=Example Sender 3 (Data)\r\n"
+            "t=0 0\r\n"
+            "m=video 50040 RTP/AVP 100\r\n"
+            "c=IN IP4 239.22.142.3/32\r\n"
+            "a=ts-refclk:ptp=IEEE1588-2008:traceable\r\n"
+            "a=source-filter: incl IN IP4 239.22.142.3 192.168.9.142\r\n"
+            "a=rtpmap:100 smpte291/90000\r\n"
+            "a=fmtp:100 DID_SDID={0x41,0x01}; DID_SDID={0x60,0x60}; \r\n"
+            "a=mediaclk:direct=0\r\n"
+        };
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testSdpParseCorpus)
+{
+    // parse the corpus, checking that each session description round-trips and that repeated parsing is consistent
+
+    const auto corpus = make_test_corpus();
+
+    std::vector<web::json::value> expected;
+    for (const auto& test_sdp : corpus)
+    {
+        expected.push_back(sdp::parse_session_description(test_sdp));
+        BST_REQUIRE_EQUAL(test_sdp, sdp::make_session_description(expected.back()));
+    }
+
+    // parsing the same session description again gives an identical result
+    for (std::size_t j = 0; j < corpus.size(); ++j)
+    {
+        BST_REQUIRE(expected[j] == sdp::parse_session_description(corpus[j]));
+    }
+}
+
+#ifdef NMOS_CPP_TEST_BENCHMARKS
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testSdpParseThroughput)
+{
+    // a simple benchmark of parsing the corpus
+    // (only built when NMOS_CPP_TEST_BENCHMARKS is defined, see cmake/NmosCppTest.cmake)
+
+    const auto corpus = make_test_corpus();
+
+    const int iterations = 10000;
+    std::size_t bytes = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        for (const auto& test_sdp : corpus)
+        {
+            BST_REQUIRE(!sdp::parse_session_description(test_sdp).is_null());
+            bytes += test_sdp.size();
+        }
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Parsed " << iterations * corpus.size() << " session descriptions (" << bytes << " bytes) in " << elapsed << " seconds"
+        << " (" << (0 != elapsed ? iterations * corpus.size() / elapsed : 0) << " per second)" << std::endl;
+}
+#endif